@@ -0,0 +1,89 @@
+#include <arba/rsce/resource_manager.hpp>
+#include <arba/rsce/resource_pack.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Compares the first loading of many small resources by a resource_manager, from files in a directory (one
+// canonical(), open, read and close each), and from entries of a mounted resource pack.
+
+constexpr std::size_t number_of_files = 16'384;
+constexpr std::size_t file_size = 1024;
+
+class blob
+{
+public:
+    std::vector<std::byte> bytes;
+
+    bool load_from_memory(std::span<const std::byte> rsc_bytes)
+    {
+        bytes.assign(rsc_bytes.begin(), rsc_bytes.end());
+        return true;
+    }
+};
+
+std::string entry_path(std::size_t index)
+{
+    return "dir_" + std::to_string(index % 64) + "/blob_" + std::to_string(index) + ".bin";
+}
+
+double resources_per_second(const std::vector<std::string>& rsc_paths, vlfs::virtual_filesystem& vlfs,
+                            const std::filesystem::path& pack_path)
+{
+    rsce::resource_manager rmanager(vlfs);
+    if (!pack_path.empty())
+        rmanager.mount_pack("PACK", pack_path);
+    std::size_t checksum = 0;
+    auto start_time = std::chrono::steady_clock::now();
+    for (const std::string& rsc_path : rsc_paths)
+        checksum += rmanager.get<blob>(rsc_path).bytes.size();
+    std::chrono::duration<double> duration = std::chrono::steady_clock::now() - start_time;
+    if (checksum != number_of_files * file_size) [[unlikely]]
+        std::cerr << "Unexpected checksum." << std::endl;
+    return static_cast<double>(rsc_paths.size()) / duration.count();
+}
+
+int main()
+{
+    const std::filesystem::path dir = std::filesystem::temp_directory_path() / "rsce_pack_loading_benchmark";
+    std::filesystem::remove_all(dir);
+    const std::filesystem::path files_dir = dir / "files";
+    const std::filesystem::path pack_path = dir / "blobs.pack";
+    rsce::resource_pack_builder builder;
+    std::vector<std::string> file_rsc_paths;
+    std::vector<std::string> pack_rsc_paths;
+    for (std::size_t i = 0; i < number_of_files; ++i)
+    {
+        std::vector<std::byte> bytes(file_size, static_cast<std::byte>(i));
+        const std::filesystem::path fpath = files_dir / entry_path(i);
+        std::filesystem::create_directories(fpath.parent_path());
+        std::ofstream(fpath, std::ios::binary).write(reinterpret_cast<const char*>(bytes.data()), file_size);
+        builder.add(entry_path(i), std::move(bytes));
+        file_rsc_paths.push_back("FILES:/" + entry_path(i));
+        pack_rsc_paths.push_back("PACK:/" + entry_path(i));
+    }
+    builder.write(pack_path);
+
+    vlfs::virtual_filesystem vlfs;
+    vlfs.set_virtual_root(strn::string64("FILES"), files_dir);
+    // Warms the page cache, so that both sources read from memory.
+    resources_per_second(file_rsc_paths, vlfs, {});
+    resources_per_second(pack_rsc_paths, vlfs, pack_path);
+
+    std::cout << number_of_files << " resources of " << file_size << " bytes" << std::endl;
+    std::cout << "  " << std::setw(9) << "files" << ": " << std::fixed << std::setprecision(1) << std::setw(10)
+              << resources_per_second(file_rsc_paths, vlfs, {}) / 1000 << " k resources/s" << std::endl;
+    std::cout << "  " << std::setw(9) << "pack" << ": " << std::fixed << std::setprecision(1) << std::setw(10)
+              << resources_per_second(pack_rsc_paths, vlfs, pack_path) / 1000 << " k resources/s" << std::endl;
+    std::filesystem::remove_all(dir);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,85 @@
+#include <arba/rsce/flat_hash_map.hpp>
+#include <arba/rsce/resource_store.hpp>
+
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// Compares the lookups of std::unordered_map and flat_hash_map, as dictionaries of resources keyed by paths (see
+// default_resource_store_policy::dictionary), for hits and misses and several numbers of resources.
+
+// Gives access to the hash and equality functions of the stores.
+struct store_functions : public rsce::resource_store_base
+{
+    using resource_store_base::filesystem_path_equal;
+    using resource_store_base::filesystem_path_hash;
+};
+using path_hash = store_functions::filesystem_path_hash;
+using path_equal = store_functions::filesystem_path_equal;
+
+template <class mapped_type>
+using unordered_path_map = std::unordered_map<std::filesystem::path, mapped_type, path_hash, path_equal>;
+template <class mapped_type>
+using flat_path_map = rsce::flat_hash_map<std::filesystem::path, mapped_type, path_hash, path_equal>;
+
+constexpr std::size_t number_of_lookups = 2'000'000;
+constexpr std::size_t number_of_resources_list[] = { 64, 4096, 262'144 };
+
+std::vector<std::filesystem::path> make_paths(std::size_t number_of_paths, std::string_view prefix)
+{
+    std::vector<std::filesystem::path> paths;
+    paths.reserve(number_of_paths);
+    for (std::size_t i = 0; i < number_of_paths; ++i)
+        paths.emplace_back(std::string(prefix) + std::to_string(i) + ".png");
+    return paths;
+}
+
+template <class dictionary_type>
+double lookups_per_second(const dictionary_type& dictionary, const std::vector<std::filesystem::path>& paths)
+{
+    std::minstd_rand random_engine(1);
+    std::size_t checksum = 0;
+    auto start_time = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < number_of_lookups; ++i)
+    {
+        auto iter = dictionary.find(paths[random_engine() % paths.size()]);
+        checksum += iter != dictionary.end() ? *iter->second : 1;
+    }
+    std::chrono::duration<double> duration = std::chrono::steady_clock::now() - start_time;
+    if (checksum == 0) [[unlikely]]
+        std::cerr << "Unexpected checksum." << std::endl;
+    return static_cast<double>(number_of_lookups) / duration.count();
+}
+
+template <class dictionary_type>
+void run_benchmark(std::string_view dictionary_name, std::size_t number_of_resources)
+{
+    const std::vector<std::filesystem::path> stored_paths = make_paths(number_of_resources, "/rsc/textures/texture_");
+    const std::vector<std::filesystem::path> missing_paths = make_paths(number_of_resources, "/rsc/textures/missing_");
+    dictionary_type dictionary;
+    for (const std::filesystem::path& path : stored_paths)
+        dictionary.emplace(path, std::make_shared<int>(1));
+
+    std::cout << "  " << std::setw(14) << dictionary_name << ": " << std::fixed << std::setprecision(2) << std::setw(8)
+              << lookups_per_second(dictionary, stored_paths) / 1'000'000 << " M hits/s, " << std::setw(8)
+              << lookups_per_second(dictionary, missing_paths) / 1'000'000 << " M misses/s" << std::endl;
+}
+
+int main()
+{
+    for (std::size_t number_of_resources : number_of_resources_list)
+    {
+        std::cout << number_of_resources << " resources" << std::endl;
+        run_benchmark<unordered_path_map<std::shared_ptr<int>>>("unordered_map", number_of_resources);
+        run_benchmark<flat_path_map<std::shared_ptr<int>>>("flat_hash_map", number_of_resources);
+    }
+    return EXIT_SUCCESS;
+}
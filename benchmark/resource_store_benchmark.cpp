@@ -0,0 +1,105 @@
+#include <arba/rsce/resource_store.hpp>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+// Measures the throughput of cache hits of default_resource_store::get_shared() from 1 to 64 threads, for several
+// store policies.
+
+class blob
+{
+public:
+    bool load_from_file(const std::filesystem::path&) { return true; }
+};
+
+constexpr std::size_t number_of_resources = 4096;
+constexpr std::size_t number_of_lookups_per_thread = 200'000;
+constexpr std::array number_of_threads_list = { 1u, 2u, 4u, 8u, 16u, 32u, 64u };
+
+std::vector<std::filesystem::path> make_resource_paths()
+{
+    std::vector<std::filesystem::path> rsc_paths;
+    rsc_paths.reserve(number_of_resources);
+    for (std::size_t i = 0; i < number_of_resources; ++i)
+        rsc_paths.emplace_back("/rsc/textures/texture_" + std::to_string(i) + ".png");
+    return rsc_paths;
+}
+
+template <class store_type>
+double lookups_per_second(store_type& store, const std::vector<std::filesystem::path>& rsc_paths,
+                          unsigned number_of_threads)
+{
+    std::atomic_bool start = false;
+    std::atomic_size_t checksum = 0;
+    std::vector<std::jthread> threads;
+    threads.reserve(number_of_threads);
+    for (unsigned thread_index = 0; thread_index < number_of_threads; ++thread_index)
+    {
+        threads.emplace_back([&, thread_index]() {
+            std::minstd_rand random_engine(thread_index + 1);
+            std::size_t local_checksum = 0;
+            while (!start.load(std::memory_order_acquire))
+                std::this_thread::yield();
+            for (std::size_t i = 0; i < number_of_lookups_per_thread; ++i)
+                local_checksum += store.get_shared(rsc_paths[random_engine() % rsc_paths.size()]).use_count();
+            checksum += local_checksum;
+        });
+    }
+
+    auto start_time = std::chrono::steady_clock::now();
+    start.store(true, std::memory_order_release);
+    threads.clear();
+    std::chrono::duration<double> duration = std::chrono::steady_clock::now() - start_time;
+    if (checksum.load() == 0) [[unlikely]]
+        std::cerr << "Unexpected checksum." << std::endl;
+    return static_cast<double>(number_of_lookups_per_thread * number_of_threads) / duration.count();
+}
+
+template <class store_type>
+void run_benchmark(std::string_view store_name, const std::vector<std::filesystem::path>& rsc_paths)
+{
+    store_type store;
+    for (const std::filesystem::path& rsc_path : rsc_paths)
+        store.insert(rsc_path, std::make_shared<blob>());
+
+    std::cout << store_name << std::endl;
+    for (unsigned number_of_threads : number_of_threads_list)
+    {
+        double throughput = lookups_per_second(store, rsc_paths, number_of_threads);
+        std::cout << "  " << std::setw(2) << number_of_threads << " threads: " << std::fixed << std::setprecision(2)
+                  << std::setw(10) << throughput / 1'000'000 << " M lookups/s" << std::endl;
+    }
+}
+
+int main()
+{
+    const std::vector<std::filesystem::path> rsc_paths = make_resource_paths();
+
+    run_benchmark<rsce::default_resource_store<blob>>("single shard (default)", rsc_paths);
+    run_benchmark<rsce::default_resource_store<blob, rsce::sharded_resource_store_policy<16>>>("16 shards",
+                                                                                              rsc_paths);
+    run_benchmark<rsce::default_resource_store<blob, rsce::sharded_resource_store_policy<64>>>("64 shards",
+                                                                                              rsc_paths);
+    run_benchmark<rsce::default_resource_store<blob, rsce::read_mostly_resource_store_policy>>("read-mostly",
+                                                                                              rsc_paths);
+    run_benchmark<rsce::default_resource_store<blob, rsce::flat_resource_store_policy>>("flat dictionary", rsc_paths);
+    run_benchmark<rsce::default_resource_store<blob, rsce::thread_cached_resource_store_policy<>>>("thread cache",
+                                                                                                   rsc_paths);
+
+    // Few resources looked up again and again, as by the handlers of requests.
+    const std::vector<std::filesystem::path> hot_rsc_paths(rsc_paths.begin(), rsc_paths.begin() + 16);
+    run_benchmark<rsce::default_resource_store<blob>>("16 hot resources, single shard (default)", hot_rsc_paths);
+    run_benchmark<rsce::default_resource_store<blob, rsce::thread_cached_resource_store_policy<>>>(
+        "16 hot resources, thread cache", hot_rsc_paths);
+
+    return EXIT_SUCCESS;
+}
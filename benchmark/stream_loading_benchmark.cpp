@@ -0,0 +1,105 @@
+#include <arba/rsce/load_resource_from_file.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Compares the stream sources of load_resource_from_file() (see rsce::stream_source), for a resource parsed value by
+// value from a binary stream, on a large file and on many small files.
+
+// Resource made of the 32-bit values of its file, read one by one.
+template <rsce::stream_source source>
+class values
+{
+public:
+    std::vector<std::uint32_t> elements;
+
+    bool load_from_binary_stream(std::istream& stream)
+    {
+        stream.seekg(0, std::ios::end);
+        elements.resize(static_cast<std::size_t>(stream.tellg()) / sizeof(std::uint32_t));
+        stream.seekg(0, std::ios::beg);
+        for (std::uint32_t& element : elements)
+            stream.read(reinterpret_cast<char*>(&element), sizeof(element));
+        return true;
+    }
+};
+
+template <rsce::stream_source source>
+inline constexpr rsce::stream_source rsce::traits::stream_source_v<values<source>> = source;
+
+struct file_set
+{
+    std::string_view name;
+    std::size_t number_of_files;
+    std::size_t file_size;
+    std::size_t number_of_passes;
+};
+
+constexpr file_set file_sets[] = {
+    { "1 file of 64 MiB", 1, 64 << 20, 8 },
+    { "4096 files of 4 KiB", 4096, 4 << 10, 8 },
+};
+
+std::vector<std::filesystem::path> make_files(const std::filesystem::path& dir, const file_set& set)
+{
+    std::vector<std::filesystem::path> paths;
+    std::vector<std::uint32_t> elements(set.file_size / sizeof(std::uint32_t));
+    for (std::size_t i = 0; i < set.number_of_files; ++i)
+    {
+        for (std::size_t j = 0; j < elements.size(); ++j)
+            elements[j] = static_cast<std::uint32_t>(i + j);
+        std::filesystem::path& path = paths.emplace_back(dir / ("values_" + std::to_string(i) + ".bin"));
+        std::ofstream stream(path, std::ios::binary);
+        stream.write(reinterpret_cast<const char*>(elements.data()), static_cast<std::streamsize>(set.file_size));
+    }
+    return paths;
+}
+
+template <rsce::stream_source source>
+double mebibytes_per_second(const std::vector<std::filesystem::path>& paths, const file_set& set)
+{
+    std::uint64_t checksum = 0;
+    auto start_time = std::chrono::steady_clock::now();
+    for (std::size_t pass = 0; pass < set.number_of_passes; ++pass)
+    {
+        for (const std::filesystem::path& path : paths)
+            checksum += rsce::load_resource_from_file<values<source>>(path)->elements.back();
+    }
+    std::chrono::duration<double> duration = std::chrono::steady_clock::now() - start_time;
+    if (checksum == 0) [[unlikely]]
+        std::cerr << "Unexpected checksum." << std::endl;
+    const double number_of_mebibytes = static_cast<double>(set.number_of_passes * set.number_of_files * set.file_size);
+    return number_of_mebibytes / (1 << 20) / duration.count();
+}
+
+int main()
+{
+    const std::filesystem::path dir = std::filesystem::temp_directory_path() / "rsce_stream_loading_benchmark";
+    for (const file_set& set : file_sets)
+    {
+        std::filesystem::remove_all(dir);
+        std::filesystem::create_directories(dir);
+        const std::vector<std::filesystem::path> paths = make_files(dir, set);
+        // Warms the page cache, so that both sources read from memory.
+        mebibytes_per_second<rsce::stream_source::file_stream>(paths, set);
+
+        std::cout << set.name << std::endl;
+        std::cout << "  " << std::setw(12) << "file_stream" << ": " << std::fixed << std::setprecision(1)
+                  << std::setw(8) << mebibytes_per_second<rsce::stream_source::file_stream>(paths, set) << " MiB/s"
+                  << std::endl;
+        std::cout << "  " << std::setw(12) << "file_mapping" << ": " << std::fixed << std::setprecision(1)
+                  << std::setw(8) << mebibytes_per_second<rsce::stream_source::file_mapping>(paths, set) << " MiB/s"
+                  << std::endl;
+    }
+    std::filesystem::remove_all(dir);
+    return EXIT_SUCCESS;
+}
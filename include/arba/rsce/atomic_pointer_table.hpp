@@ -0,0 +1,131 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <memory>
+
+inline namespace arba
+{
+namespace rsce
+{
+
+// Table of owned pointers, indexed by integers, whose elements are set once and never replaced. Reading an element is
+// an acquire load (two beyond the first segment), and setting it is a compare-and-swap: no lock is taken. The first
+// segment is stored in the table, the others are allocated on demand with doubling sizes and never moved.
+template <class value_type, std::size_t first_segment_size = 32>
+class atomic_pointer_table
+{
+    static_assert(std::has_single_bit(first_segment_size));
+
+public:
+    atomic_pointer_table() = default;
+    atomic_pointer_table(const atomic_pointer_table&) = delete;
+    atomic_pointer_table& operator=(const atomic_pointer_table&) = delete;
+    ~atomic_pointer_table()
+    {
+        for (std::atomic<value_type*>& element : first_segment_)
+            delete element.load(std::memory_order_relaxed);
+        for (std::size_t segment_index = 1; segment_index < max_number_of_segments; ++segment_index)
+        {
+            std::atomic<value_type*>* segment = segments_[segment_index].load(std::memory_order_relaxed);
+            if (!segment)
+                continue;
+            for (std::size_t i = 0; i < segment_size_(segment_index); ++i)
+                delete segment[i].load(std::memory_order_relaxed);
+            delete[] segment;
+        }
+    }
+
+    // Returns nullptr if no element was set at index.
+    inline value_type* get(std::size_t index) const noexcept
+    {
+        const std::atomic<value_type*>* element = element_(index);
+        return element ? element->load(std::memory_order_acquire) : nullptr;
+    }
+
+    // Sets the element at index to value_uptr, unless it is already set. Returns the element at index.
+    value_type* try_set(std::size_t index, std::unique_ptr<value_type> value_uptr)
+    {
+        std::atomic<value_type*>& element = get_or_create_element_(index);
+        value_type* value_ptr = nullptr;
+        if (element.compare_exchange_strong(value_ptr, value_uptr.get(), std::memory_order_acq_rel,
+                                            std::memory_order_acquire))
+            return value_uptr.release();
+        return value_ptr;
+    }
+
+    // Calls function with each element which is set.
+    template <class function_type>
+    void for_each(function_type&& function) const
+    {
+        for (const std::atomic<value_type*>& element : first_segment_)
+        {
+            if (value_type* value_ptr = element.load(std::memory_order_acquire))
+                function(*value_ptr);
+        }
+        for (std::size_t segment_index = 1; segment_index < max_number_of_segments; ++segment_index)
+        {
+            const std::atomic<value_type*>* segment = segments_[segment_index].load(std::memory_order_acquire);
+            if (!segment)
+                continue;
+            for (std::size_t i = 0; i < segment_size_(segment_index); ++i)
+            {
+                if (value_type* value_ptr = segment[i].load(std::memory_order_acquire))
+                    function(*value_ptr);
+            }
+        }
+    }
+
+private:
+    inline static std::size_t segment_index_(std::size_t index) noexcept
+    {
+        return std::bit_width(index / first_segment_size + 1) - 1;
+    }
+
+    inline static std::size_t segment_begin_(std::size_t segment_index) noexcept
+    {
+        return first_segment_size * ((std::size_t(1) << segment_index) - 1);
+    }
+
+    inline static std::size_t segment_size_(std::size_t segment_index) noexcept
+    {
+        return first_segment_size << segment_index;
+    }
+
+    inline const std::atomic<value_type*>* element_(std::size_t index) const noexcept
+    {
+        if (index < first_segment_size) [[likely]]
+            return &first_segment_[index];
+        const std::size_t segment_index = segment_index_(index);
+        const std::atomic<value_type*>* segment = segments_[segment_index].load(std::memory_order_acquire);
+        return segment ? &segment[index - segment_begin_(segment_index)] : nullptr;
+    }
+
+    std::atomic<value_type*>& get_or_create_element_(std::size_t index)
+    {
+        if (index < first_segment_size) [[likely]]
+            return first_segment_[index];
+        const std::size_t segment_index = segment_index_(index);
+        std::atomic<std::atomic<value_type*>*>& segment_ref = segments_[segment_index];
+        std::atomic<value_type*>* segment = segment_ref.load(std::memory_order_acquire);
+        if (!segment)
+        {
+            std::unique_ptr new_segment = std::make_unique<std::atomic<value_type*>[]>(segment_size_(segment_index));
+            if (segment_ref.compare_exchange_strong(segment, new_segment.get(), std::memory_order_acq_rel,
+                                                    std::memory_order_acquire))
+                segment = new_segment.release();
+        }
+        return segment[index - segment_begin_(segment_index)];
+    }
+
+    static constexpr std::size_t max_number_of_segments = 48;
+
+    std::array<std::atomic<value_type*>, first_segment_size> first_segment_{};
+    // The first segment is first_segment_: segments_[0] is unused.
+    std::array<std::atomic<std::atomic<value_type*>*>, max_number_of_segments> segments_{};
+};
+
+} // namespace rsce
+} // namespace arba
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include <vector>
+
+inline namespace arba
+{
+namespace rsce
+{
+
+// Process-wide hazard pointer slots, one per reading thread. A reader publishes in its slot the snapshot it is
+// reading, so that writers do not destroy it meanwhile. Only the slot owner writes in a slot, so readers never
+// write to a shared cache line.
+class hazard_pointer_slots
+{
+public:
+    static constexpr std::size_t max_number_of_slots = 256;
+
+    // Returns the slot of the calling thread, or nullptr if every slot is already owned by another thread.
+    static std::atomic<const void*>* thread_slot() noexcept;
+    static bool is_protected(const void* ptr) noexcept;
+};
+
+// Immutable value published atomically: readers take no lock, writers (which must be serialized by the caller)
+// replace the whole value and destroy the old one once no reader uses it anymore.
+template <class value_type>
+class atomic_snapshot
+{
+public:
+    atomic_snapshot() = default;
+    explicit atomic_snapshot(std::unique_ptr<const value_type> value) : value_(value.release()) {}
+    atomic_snapshot(const atomic_snapshot&) = delete;
+    atomic_snapshot& operator=(const atomic_snapshot&) = delete;
+    ~atomic_snapshot();
+
+    // Calls function(const value_type&) on the current value. Returns false, without calling function, if the
+    // calling thread has no hazard pointer slot available. The function must not read another atomic_snapshot.
+    template <class function_type>
+    bool visit(function_type&& function) const;
+
+    void store(std::unique_ptr<const value_type> value);
+
+private:
+    std::atomic<const value_type*> value_ = nullptr;
+    std::vector<const value_type*> retired_values_;
+};
+
+template <class value_type>
+atomic_snapshot<value_type>::~atomic_snapshot()
+{
+    delete value_.load();
+    for (const value_type* retired_value : retired_values_)
+        delete retired_value;
+}
+
+template <class value_type>
+template <class function_type>
+bool atomic_snapshot<value_type>::visit(function_type&& function) const
+{
+    std::atomic<const void*>* slot = hazard_pointer_slots::thread_slot();
+    if (!slot) [[unlikely]]
+        return false;
+
+    // Clears the slot even if function throws, so that the visited value can still be destroyed.
+    struct slot_clearer
+    {
+        std::atomic<const void*>* slot;
+        inline ~slot_clearer() { slot->store(nullptr, std::memory_order_release); }
+    } clearer{ slot };
+
+    const value_type* value = value_.load(std::memory_order_acquire);
+    for (;;)
+    {
+        slot->store(value, std::memory_order_seq_cst);
+        const value_type* current_value = value_.load(std::memory_order_seq_cst);
+        if (current_value == value) [[likely]]
+            break;
+        value = current_value;
+    }
+    std::forward<function_type>(function)(*value);
+    return true;
+}
+
+template <class value_type>
+void atomic_snapshot<value_type>::store(std::unique_ptr<const value_type> value)
+{
+    if (const value_type* old_value = value_.exchange(value.release(), std::memory_order_seq_cst))
+        retired_values_.push_back(old_value);
+    std::erase_if(retired_values_, [](const value_type* retired_value) {
+        if (hazard_pointer_slots::is_protected(retired_value))
+            return false;
+        delete retired_value;
+        return true;
+    });
+}
+
+} // namespace rsce
+} // namespace arba
@@ -1,22 +1,70 @@
 #pragma once
 
+#include "atomic_pointer_table.hpp"
+#include "counting_loader_executor.hpp"
 #include "resource_store.hpp"
 
+#include <algorithm>
 #include <atomic>
-#include <shared_mutex>
+#include <chrono>
+#include <concepts>
+#include <functional>
+#include <span>
+#include <string_view>
+#include <typeindex>
 #include <typeinfo>
+#include <vector>
 
 inline namespace arba
 {
 namespace rsce
 {
 
+class basic_resource_manager;
+
+// Resource of any type to preload with basic_resource_manager::preload().
+class resource_preload_entry
+{
+public:
+    using preload_function = resource_preloading (*)(basic_resource_manager&, std::span<const std::filesystem::path>);
+
+    template <class resource>
+    inline static resource_preload_entry make(std::filesystem::path rsc_path);
+
+    inline const std::filesystem::path& path() const { return path_; }
+    inline std::type_index resource_type() const { return resource_type_; }
+    inline preload_function preload_async() const { return preload_async_; }
+
+private:
+    inline resource_preload_entry(std::filesystem::path rsc_path, std::type_index rsc_type,
+                                  preload_function preload_async)
+        : path_(std::move(rsc_path)), resource_type_(rsc_type), preload_async_(preload_async)
+    {
+    }
+
+    std::filesystem::path path_;
+    std::type_index resource_type_;
+    preload_function preload_async_;
+};
+
 class basic_resource_manager
 {
 public:
     basic_resource_manager() = default;
+    // The loader threads, used by asynchronous loadings, are started on the first asynchronous loading. At least one
+    // loader thread is started, even if number_of_loader_threads is 0.
+    explicit basic_resource_manager(std::size_t number_of_loader_threads)
+        : counting_executor_(number_of_loader_threads)
+    {
+    }
+    // The asynchronous loadings are submitted to executor, which may be shared with other managers.
+    explicit basic_resource_manager(std::shared_ptr<loader_executor> executor) : counting_executor_(std::move(executor))
+    {
+    }
     basic_resource_manager(const basic_resource_manager&) = delete;
     basic_resource_manager& operator=(const basic_resource_manager&) = delete;
+    // Waits for the asynchronous loadings submitted by this manager (see counting_loader_executor).
+    ~basic_resource_manager() = default;
 
     template <class resource>
     inline std::shared_ptr<resource> get_shared(const std::filesystem::path& rsc_path)
@@ -24,18 +72,53 @@ public:
         return get_or_create_resource_store_<resource>().get_shared(rsc_path, *this);
     }
 
+    // A cache hit constructs no path (see default_resource_store::find()).
+    template <class resource, concepts::path_string string_type>
+    inline std::shared_ptr<resource> get_shared(const string_type& rsc_path)
+    {
+        return get_or_create_resource_store_<resource>().get_shared(rsc_path, *this);
+    }
+
+    // A cache hit does not hash rsc_path (see hashed_path).
+    template <class resource>
+    inline std::shared_ptr<resource> get_shared(hashed_path_view rsc_path)
+    {
+        return get_or_create_resource_store_<resource>().get_shared(rsc_path, *this);
+    }
+
+    template <class resource>
+    inline std::shared_ptr<resource> get_shared(resource_id<resource> rsc_id)
+    {
+        return get_or_create_resource_store_<resource>().get_shared(rsc_id, *this);
+    }
+
+    template <class resource>
+    inline resource_id<resource> intern(const std::filesystem::path& rsc_path)
+    {
+        return get_or_create_resource_store_<resource>().intern(rsc_path);
+    }
+
+    // Cheaper than get_shared() when the resource is accessed often, and safer than get() (see resource_handle).
+    template <class resource>
+    inline resource_handle<resource> get_handle(const std::filesystem::path& rsc_path)
+    {
+        return get_or_create_resource_store_<resource>().get_handle(rsc_path, *this);
+    }
+
     template <class resource>
     inline std::shared_ptr<resource> get_shared(const std::filesystem::path& rsc_path, std::nothrow_t)
     {
-        try
-        {
-            return get_or_create_resource_store_<resource>().get_shared(rsc_path, *this);
-        }
-        catch (const std::exception&)
-        {
-        }
-        return std::shared_ptr<resource>();
+        return get_or_create_resource_store_<resource>().get_shared(rsc_path, *this, std::nothrow);
+    }
+
+#ifdef ARBA_RSCE_HAS_EXPECTED
+    // A failure is returned instead of thrown (see default_resource_store::try_get_shared()).
+    template <class resource>
+    inline std::expected<std::shared_ptr<resource>, load_error> try_get_shared(const std::filesystem::path& rsc_path)
+    {
+        return get_or_create_resource_store_<resource>().try_get_shared(rsc_path, *this);
     }
+#endif
 
     template <class resource>
     inline resource& get(const std::filesystem::path& rsc_path)
@@ -43,6 +126,18 @@ public:
         return *get_shared<resource>(rsc_path);
     }
 
+    template <class resource, concepts::path_string string_type>
+    inline resource& get(const string_type& rsc_path)
+    {
+        return *get_shared<resource>(rsc_path);
+    }
+
+    template <class resource>
+    inline resource& get(hashed_path_view rsc_path)
+    {
+        return *get_shared<resource>(rsc_path);
+    }
+
     template <class resource>
     inline bool insert(const std::filesystem::path& rsc_path, std::shared_ptr<resource> rsc_sptr)
     {
@@ -56,22 +151,71 @@ public:
     }
 
     template <class resource>
-    inline std::shared_ptr<resource> load(const std::filesystem::path& rsc_path)
+    inline std::shared_ptr<resource> load(const std::filesystem::path& rsc_path, load_mode mode = load_mode::force)
     {
-        return get_or_create_resource_store_<resource>().load(rsc_path, *this);
+        return get_or_create_resource_store_<resource>().load(rsc_path, *this, mode);
     }
 
     template <class resource>
     inline std::shared_ptr<resource> load(const std::filesystem::path& rsc_path, std::nothrow_t)
     {
-        try
-        {
-            return get_or_create_resource_store_<resource>().load(rsc_path, *this);
-        }
-        catch (const std::exception&)
-        {
-        }
-        return std::shared_ptr<resource>();
+        return get_or_create_resource_store_<resource>().load(rsc_path, *this, std::nothrow);
+    }
+
+    template <class resource>
+    inline resource_future<resource> get_shared_async(const std::filesystem::path& rsc_path)
+    {
+        return get_or_create_resource_store_<resource>().get_shared_async(rsc_path, *this, counting_executor_);
+    }
+
+    template <class resource>
+    inline resource_future<resource> load_async(const std::filesystem::path& rsc_path,
+                                                load_mode mode = load_mode::force)
+    {
+        return get_or_create_resource_store_<resource>().load_async(rsc_path, *this, counting_executor_, mode);
+    }
+
+    // Loads in parallel the resources which are not stored yet, then inserts them in the store.
+    template <class resource>
+    inline void preload(std::span<const std::filesystem::path> rsc_paths)
+    {
+        preload_async<resource>(rsc_paths).wait();
+    }
+
+    template <class resource>
+    inline resource_preloading preload_async(std::span<const std::filesystem::path> rsc_paths)
+    {
+        return get_or_create_resource_store_<resource>().preload_async(rsc_paths, *this, counting_executor_);
+    }
+
+    // Preloads resources of several types, all in parallel.
+    inline void preload(std::span<const resource_preload_entry> entries)
+    {
+        preload_(entries, [](const std::filesystem::path& rsc_path) { return rsc_path; });
+    }
+
+    // Preloads the regular files of directory (and of its subdirectories if recursive) accepted by predicate.
+    template <class resource, std::predicate<const std::filesystem::path&> predicate_type>
+    inline resource_preload_summary preload_directory(const std::filesystem::path& directory, bool recursive,
+                                                      predicate_type predicate)
+    {
+        return preload_directory_(directory, recursive, std::move(predicate),
+                                  [this](std::span<const std::filesystem::path> rsc_paths) {
+                                      return preload_async<resource>(rsc_paths);
+                                  });
+    }
+
+    template <class resource>
+    inline resource_preload_summary preload_directory(const std::filesystem::path& directory, bool recursive,
+                                                      std::string_view extension)
+    {
+        return preload_directory<resource>(directory, recursive, extension_predicate_(extension));
+    }
+
+    template <class resource>
+    inline resource_preload_summary preload_directory(const std::filesystem::path& directory, bool recursive = true)
+    {
+        return preload_directory<resource>(directory, recursive, [](const std::filesystem::path&) { return true; });
     }
 
     template <class resource>
@@ -80,6 +224,18 @@ public:
         get_store_<resource>().remove(rsc_path);
     }
 
+    // Forgets the canonical paths cached by the resource stores, to be called when files or links were moved.
+    inline void invalidate_canonical_paths()
+    {
+        resource_stores_.for_each([](resource_store_base& rsc_store) { rsc_store.invalidate_canonical_paths(); });
+    }
+
+    // Forgets the failures remembered by the resource stores, to be called when files were added or fixed.
+    inline void forget_failures()
+    {
+        resource_stores_.for_each([](resource_store_base& rsc_store) { rsc_store.forget_failures(); });
+    }
+
     template <class resource>
     inline std::size_t number_of_resources()
     {
@@ -93,14 +249,18 @@ public:
     }
 
 protected:
+    // True if a resource store was created, i.e. if a resource was looked up, stored or loaded.
+    inline bool has_resource_stores_() const
+    {
+        bool has_stores = false;
+        resource_stores_.for_each([&has_stores](const resource_store_base&) { has_stores = true; });
+        return has_stores;
+    }
+
     template <class resource>
     inline resource_store<resource>& get_store_()
     {
-        std::size_t rsc_type_index = resource_type_index_<resource>();
-        std::shared_lock lock(mutex_);
-        if (rsc_type_index >= resource_stores_.size()) [[unlikely]]
-            throw_resource_store_is_missing_<resource>();
-        resource_store_base* resource_store_ptr = resource_stores_[rsc_type_index].get();
+        resource_store_base* resource_store_ptr = resource_stores_.get(resource_type_index_<resource>());
         if (!resource_store_ptr) [[unlikely]]
             throw_resource_store_is_missing_<resource>();
         return *static_cast<resource_store<resource>*>(resource_store_ptr);
@@ -117,27 +277,97 @@ protected:
     template <class resource>
     inline resource_store<resource>& get_or_create_resource_store_()
     {
-        std::size_t rsc_type_index = resource_type_index_<resource>();
+        const std::size_t rsc_type_index = resource_type_index_<resource>();
+        resource_store_base* resource_store_ptr = resource_stores_.get(rsc_type_index);
+        if (!resource_store_ptr) [[unlikely]]
+        {
+            // If another thread creates the store first, its store is kept and this one is destroyed.
+            resource_store_ptr = resource_stores_.try_set(rsc_type_index, std::make_unique<resource_store<resource>>());
+        }
+
+        return *static_cast<resource_store<resource>*>(resource_store_ptr);
+    }
+
+    template <class path_resolver_type>
+    void preload_(std::span<const resource_preload_entry> entries, path_resolver_type path_resolver)
+    {
+        std::vector<const resource_preload_entry*> sorted_entries;
+        sorted_entries.reserve(entries.size());
+        for (const resource_preload_entry& entry : entries)
+            sorted_entries.push_back(&entry);
+        std::ranges::stable_sort(sorted_entries, std::less{},
+                                 [](const resource_preload_entry* entry) { return entry->resource_type(); });
 
-        resource_store_base* resource_store_ptr = nullptr;
+        std::vector<resource_preloading> preloadings;
+        std::vector<std::filesystem::path> rsc_paths;
+        for (auto type_begin = sorted_entries.begin(); type_begin != sorted_entries.end();)
         {
-            std::shared_lock lock(mutex_);
-            if (rsc_type_index < resource_stores_.size()) [[likely]]
-                resource_store_ptr = resource_stores_[rsc_type_index].get();
+            const resource_preload_entry& entry = **type_begin;
+            auto type_end = std::find_if(type_begin, sorted_entries.end(), [&entry](const resource_preload_entry* rsc) {
+                return rsc->resource_type() != entry.resource_type();
+            });
+            rsc_paths.clear();
+            for (auto iter = type_begin; iter != type_end; ++iter)
+                rsc_paths.push_back(path_resolver((*iter)->path()));
+            preloadings.push_back(entry.preload_async()(*this, rsc_paths));
+            type_begin = type_end;
         }
+        resource_preloading::wait_all(preloadings);
+    }
 
-        if (!resource_store_ptr) [[unlikely]]
+    template <class predicate_type, class preload_function_type>
+    resource_preload_summary preload_directory_(const std::filesystem::path& directory, bool recursive,
+                                                predicate_type predicate, preload_function_type preload_function)
+    {
+        const std::chrono::steady_clock::time_point start_time = std::chrono::steady_clock::now();
+
+        std::vector<std::filesystem::path> rsc_paths;
+        std::vector<std::uintmax_t> file_sizes;
+        auto add_file = [&](const std::filesystem::directory_entry& entry) {
+            std::error_code error_code;
+            if (!entry.is_regular_file(error_code) || !predicate(entry.path()))
+                return;
+            const std::uintmax_t file_size = entry.file_size(error_code);
+            rsc_paths.push_back(entry.path());
+            file_sizes.push_back(error_code ? 0 : file_size);
+        };
+        constexpr auto options = std::filesystem::directory_options::skip_permission_denied;
+        if (recursive)
+        {
+            for (const std::filesystem::directory_entry& entry :
+                 std::filesystem::recursive_directory_iterator(directory, options))
+                add_file(entry);
+        }
+        else
         {
-            std::unique_lock lock(mutex_);
-            std::size_t min_required_size = rsc_type_index + 1;
-            if (min_required_size > resource_stores_.size())
-                resource_stores_.resize(min_required_size);
-            std::unique_ptr rsc_store_uptr = std::make_unique<resource_store<resource>>();
-            resource_store_ptr = rsc_store_uptr.get();
-            resource_stores_[rsc_type_index] = std::move(rsc_store_uptr);
+            for (const std::filesystem::directory_entry& entry :
+                 std::filesystem::directory_iterator(directory, options))
+                add_file(entry);
         }
 
-        return *static_cast<resource_store<resource>*>(resource_store_ptr);
+        resource_preload_summary summary;
+        summary.failures = preload_function(std::span<const std::filesystem::path>(rsc_paths)).wait(std::nothrow);
+        std::vector<std::filesystem::path::string_type> failed_paths;
+        failed_paths.reserve(summary.failures.size());
+        for (const resource_load_failure& failure : summary.failures)
+            failed_paths.push_back(failure.path.native());
+        std::ranges::sort(failed_paths);
+        for (std::size_t i = 0; i < rsc_paths.size(); ++i)
+        {
+            if (std::ranges::binary_search(failed_paths, rsc_paths[i].native()))
+                continue;
+            ++summary.number_of_resources;
+            summary.number_of_bytes += file_sizes[i];
+        }
+        summary.duration = std::chrono::steady_clock::now() - start_time;
+        return summary;
+    }
+
+    inline static auto extension_predicate_(std::string_view extension)
+    {
+        return [extension = std::filesystem::path(extension)](const std::filesystem::path& rsc_path) {
+            return rsc_path.extension() == extension;
+        };
     }
 
     inline static std::size_t generate_resource_type_index_()
@@ -153,12 +383,27 @@ protected:
         return index;
     }
 
-    using resource_store_interface_uptr = std::unique_ptr<resource_store_base>;
-
 private:
-    std::vector<resource_store_interface_uptr> resource_stores_;
-    mutable std::shared_mutex mutex_;
+    // Indexed by resource_type_index_().
+    atomic_pointer_table<resource_store_base> resource_stores_;
+
+protected:
+    // Declared after the resource stores, so that the pending loadings are waited for and an owned loader thread pool
+    // is joined before the stores are destroyed.
+    counting_loader_executor counting_executor_;
 };
 
+// Template methods implementation:
+
+template <class resource>
+resource_preload_entry resource_preload_entry::make(std::filesystem::path rsc_path)
+{
+    preload_function preload_async = [](basic_resource_manager& rsc_manager,
+                                         std::span<const std::filesystem::path> rsc_paths) {
+        return rsc_manager.preload_async<resource>(rsc_paths);
+    };
+    return resource_preload_entry(std::move(rsc_path), typeid(resource), preload_async);
+}
+
 } // namespace rsce
 } // namespace arba
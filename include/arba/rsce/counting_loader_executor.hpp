@@ -0,0 +1,45 @@
+#pragma once
+
+#include "loader_thread_pool.hpp"
+
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+
+inline namespace arba
+{
+namespace rsce
+{
+
+// Executor given by a resource manager to its resource stores: it counts the pending loadings, so that they never
+// outlive the manager. Loadings are submitted to a loader executor, which may be shared with other managers, or to a
+// loader thread pool started on the first submission.
+class counting_loader_executor
+{
+public:
+    // At least one loader thread is started, even if number_of_loader_threads is 0.
+    explicit counting_loader_executor(
+        std::size_t number_of_loader_threads = loader_thread_pool::default_number_of_threads());
+    explicit counting_loader_executor(std::shared_ptr<loader_executor> executor);
+    counting_loader_executor(const counting_loader_executor&) = delete;
+    counting_loader_executor& operator=(const counting_loader_executor&) = delete;
+    // Waits for the pending loadings.
+    ~counting_loader_executor();
+
+    void submit(std::function<void()> task);
+
+    loader_executor& executor();
+
+private:
+    std::size_t number_of_loader_threads_;
+    std::shared_ptr<loader_executor> loader_executor_sptr_;
+    std::once_flag loader_executor_flag_;
+    std::size_t number_of_pending_loadings_ = 0;
+    std::mutex pending_loadings_mutex_;
+    std::condition_variable pending_loadings_condition_;
+};
+
+} // namespace rsce
+} // namespace arba
@@ -0,0 +1,382 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <utility>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define ARBA_RSCE_FLAT_HASH_MAP_SSE2 1
+#endif
+
+inline namespace arba
+{
+namespace rsce
+{
+
+// Open-addressing hash map, probing groups of 16 slots at once (Swiss table design). A control byte per slot holds
+// 7 bits of the hash of its key, compared for a whole group with one SIMD instruction. A slot holds the full hash
+// and a pointer to its entry, so that most mismatching keys are rejected without accessing the entry, and entries
+// never move: references and iterators on entries stay valid until they are erased.
+// The interface is the subset of std::unordered_map used by the resource stores; lookups are heterogeneous when
+// hash_type and key_equal_type are transparent.
+template <class key_type, class mapped_type, class hash_type, class key_equal_type>
+class flat_hash_map
+{
+public:
+    using value_type = std::pair<const key_type, mapped_type>;
+    using size_type = std::size_t;
+    using hasher = hash_type;
+    using key_equal = key_equal_type;
+
+private:
+    using control_byte = std::int8_t;
+    static constexpr control_byte empty_control = -128;
+    static constexpr control_byte deleted_control = -2;
+    static constexpr std::size_t group_size = 16;
+
+    struct slot
+    {
+        std::size_t hash;
+        value_type* entry;
+    };
+
+    template <bool is_const>
+    class basic_iterator
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = std::conditional_t<is_const, const flat_hash_map::value_type, flat_hash_map::value_type>;
+        using difference_type = std::ptrdiff_t;
+        using pointer = value_type*;
+        using reference = value_type&;
+
+        basic_iterator() = default;
+        // Conversion of an iterator to a const iterator.
+        template <bool other_is_const>
+            requires(is_const && !other_is_const)
+        basic_iterator(const basic_iterator<other_is_const>& other) : map_(other.map_), index_(other.index_)
+        {
+        }
+
+        inline reference operator*() const { return *map_->slots_[index_].entry; }
+        inline pointer operator->() const { return map_->slots_[index_].entry; }
+
+        inline basic_iterator& operator++()
+        {
+            index_ = map_->next_full_index_(index_ + 1);
+            return *this;
+        }
+
+        inline basic_iterator operator++(int)
+        {
+            basic_iterator iter = *this;
+            ++*this;
+            return iter;
+        }
+
+        inline bool operator==(const basic_iterator& other) const { return index_ == other.index_; }
+
+    private:
+        friend class flat_hash_map;
+        friend class basic_iterator<!is_const>;
+
+        using map_pointer = std::conditional_t<is_const, const flat_hash_map*, flat_hash_map*>;
+
+        basic_iterator(map_pointer map, std::size_t index) : map_(map), index_(index) {}
+
+        map_pointer map_ = nullptr;
+        std::size_t index_ = 0;
+    };
+
+public:
+    using iterator = basic_iterator<false>;
+    using const_iterator = basic_iterator<true>;
+
+    flat_hash_map() = default;
+
+    flat_hash_map(const flat_hash_map& other) : hash_(other.hash_), key_equal_(other.key_equal_)
+    {
+        reserve(other.size_);
+        // The destructor is not run if the constructor throws: the entries already copied are destroyed here.
+        try
+        {
+            for (const value_type& value : other)
+            {
+                std::unique_ptr<value_type> entry = std::make_unique<value_type>(value);
+                insert_new_(hash_(entry->first), entry.get());
+                entry.release();
+            }
+        }
+        catch (...)
+        {
+            destroy_entries_();
+            throw;
+        }
+    }
+
+    flat_hash_map(flat_hash_map&& other) noexcept { swap(other); }
+
+    flat_hash_map& operator=(flat_hash_map other) noexcept
+    {
+        swap(other);
+        return *this;
+    }
+
+    ~flat_hash_map() { destroy_entries_(); }
+
+    inline void swap(flat_hash_map& other) noexcept
+    {
+        std::swap(controls_, other.controls_);
+        std::swap(slots_, other.slots_);
+        std::swap(capacity_, other.capacity_);
+        std::swap(size_, other.size_);
+        std::swap(growth_left_, other.growth_left_);
+        std::swap(hash_, other.hash_);
+        std::swap(key_equal_, other.key_equal_);
+    }
+
+    inline iterator begin() { return iterator(this, next_full_index_(0)); }
+    inline iterator end() { return iterator(this, capacity_); }
+    inline const_iterator begin() const { return const_iterator(this, next_full_index_(0)); }
+    inline const_iterator end() const { return const_iterator(this, capacity_); }
+
+    inline size_type size() const { return size_; }
+    inline bool empty() const { return size_ == 0; }
+
+    void clear()
+    {
+        destroy_entries_();
+        if (capacity_ > 0)
+            std::fill_n(controls_.get(), capacity_, empty_control);
+        size_ = 0;
+        growth_left_ = max_load_(capacity_);
+    }
+
+    void reserve(size_type count)
+    {
+        if (count <= size_ + growth_left_)
+            return;
+        std::size_t new_capacity = std::max(group_size, capacity_);
+        while (max_load_(new_capacity) < count)
+            new_capacity *= 2;
+        rehash_(new_capacity);
+    }
+
+    template <class lookup_key_type>
+    inline iterator find(const lookup_key_type& key)
+    {
+        return iterator(this, find_index_(key, hash_(key)));
+    }
+
+    template <class lookup_key_type>
+    inline const_iterator find(const lookup_key_type& key) const
+    {
+        return const_iterator(this, find_index_(key, hash_(key)));
+    }
+
+    template <class lookup_key_type>
+    inline bool contains(const lookup_key_type& key) const
+    {
+        return find_index_(key, hash_(key)) != capacity_;
+    }
+
+    // The value is constructed only if key is not found.
+    template <class key_arg_type, class... mapped_args_types>
+    std::pair<iterator, bool> try_emplace(key_arg_type&& key, mapped_args_types&&... mapped_args)
+    {
+        const std::size_t hash = hash_(key);
+        if (std::size_t index = find_index_(key, hash); index != capacity_)
+            return { iterator(this, index), false };
+        std::unique_ptr<value_type> entry = std::make_unique<value_type>(
+            std::piecewise_construct, std::forward_as_tuple(std::forward<key_arg_type>(key)),
+            std::forward_as_tuple(std::forward<mapped_args_types>(mapped_args)...));
+        const std::size_t index = insert_new_(hash, entry.get());
+        entry.release();
+        return { iterator(this, index), true };
+    }
+
+    template <class key_arg_type, class mapped_arg_type>
+    inline std::pair<iterator, bool> emplace(key_arg_type&& key, mapped_arg_type&& mapped)
+    {
+        return try_emplace(std::forward<key_arg_type>(key), std::forward<mapped_arg_type>(mapped));
+    }
+
+    inline std::pair<iterator, bool> insert(const value_type& value) { return try_emplace(value.first, value.second); }
+
+    inline mapped_type& operator[](const key_type& key) { return try_emplace(key).first->second; }
+
+    template <class lookup_key_type>
+    size_type erase(const lookup_key_type& key)
+    {
+        const std::size_t index = find_index_(key, hash_(key));
+        if (index == capacity_)
+            return 0;
+        erase_index_(index);
+        return 1;
+    }
+
+private:
+    // Maximum number of entries for a capacity: 7/8 of the slots.
+    inline static std::size_t max_load_(std::size_t capacity) { return capacity - capacity / 8; }
+
+    // The 7 highest bits of the hash: the keys of a map often share their lowest bits (e.g. the keys of a shard of
+    // default_resource_store, chosen by hash % number_of_shards), and the group index uses the bits above the 7th.
+    inline static control_byte h2_(std::size_t hash)
+    {
+        return static_cast<control_byte>(hash >> (sizeof(std::size_t) * 8 - 7));
+    }
+
+    // Bit i of the returned mask is set if control byte i of the group equals value.
+    inline static std::uint32_t match_(const control_byte* group, control_byte value)
+    {
+#ifdef ARBA_RSCE_FLAT_HASH_MAP_SSE2
+        const __m128i controls = _mm_loadu_si128(reinterpret_cast<const __m128i*>(group));
+        return static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(controls, _mm_set1_epi8(value))));
+#else
+        std::uint32_t mask = 0;
+        for (std::size_t i = 0; i < group_size; ++i)
+            mask |= static_cast<std::uint32_t>(group[i] == value) << i;
+        return mask;
+#endif
+    }
+
+    // Bit i of the returned mask is set if slot i of the group is empty or deleted.
+    inline static std::uint32_t match_empty_or_deleted_(const control_byte* group)
+    {
+#ifdef ARBA_RSCE_FLAT_HASH_MAP_SSE2
+        // Empty and deleted control bytes are the negative ones, full ones are in [0, 127].
+        const __m128i controls = _mm_loadu_si128(reinterpret_cast<const __m128i*>(group));
+        return static_cast<std::uint32_t>(_mm_movemask_epi8(controls));
+#else
+        std::uint32_t mask = 0;
+        for (std::size_t i = 0; i < group_size; ++i)
+            mask |= static_cast<std::uint32_t>(group[i] < 0) << i;
+        return mask;
+#endif
+    }
+
+    // Quadratic probing over the groups: the sequence visits every group once as their number is a power of 2.
+    inline std::size_t probe_group_(std::size_t hash, std::size_t probe_index) const
+    {
+        const std::size_t number_of_groups = capacity_ / group_size;
+        return ((hash >> 7) + probe_index * (probe_index + 1) / 2) & (number_of_groups - 1);
+    }
+
+    template <class lookup_key_type>
+    std::size_t find_index_(const lookup_key_type& key, std::size_t hash) const
+    {
+        if (size_ == 0) [[unlikely]]
+            return capacity_;
+        const control_byte h2 = h2_(hash);
+        const std::size_t number_of_groups = capacity_ / group_size;
+        for (std::size_t probe_index = 0; probe_index < number_of_groups; ++probe_index)
+        {
+            const std::size_t group_begin = probe_group_(hash, probe_index) * group_size;
+            const control_byte* group = controls_.get() + group_begin;
+            for (std::uint32_t mask = match_(group, h2); mask != 0; mask &= mask - 1)
+            {
+                const std::size_t index = group_begin + std::countr_zero(mask);
+                const slot& candidate = slots_[index];
+                if (candidate.hash == hash && key_equal_(candidate.entry->first, key)) [[likely]]
+                    return index;
+            }
+            if (match_(group, empty_control) != 0) [[likely]]
+                return capacity_;
+        }
+        return capacity_;
+    }
+
+    // The key of entry must not be in the map.
+    std::size_t insert_new_(std::size_t hash, value_type* entry)
+    {
+        if (growth_left_ == 0) [[unlikely]]
+        {
+            // Rehashing in place removes the deleted slots if they are numerous, otherwise the capacity is doubled.
+            rehash_(size_ + 1 > max_load_(capacity_) / 2 ? std::max(group_size, capacity_ * 2) : capacity_);
+        }
+        for (std::size_t probe_index = 0;; ++probe_index)
+        {
+            const std::size_t group_begin = probe_group_(hash, probe_index) * group_size;
+            if (std::uint32_t mask = match_empty_or_deleted_(controls_.get() + group_begin); mask != 0)
+            {
+                const std::size_t index = group_begin + std::countr_zero(mask);
+                if (controls_[index] == empty_control)
+                    --growth_left_;
+                controls_[index] = h2_(hash);
+                slots_[index] = slot{ hash, entry };
+                ++size_;
+                return index;
+            }
+        }
+    }
+
+    void erase_index_(std::size_t index)
+    {
+        delete slots_[index].entry;
+        slots_[index].entry = nullptr;
+        // A slot of a group which has an empty slot can be emptied: no probe sequence continued past this group.
+        const std::size_t group_begin = index - index % group_size;
+        if (match_(controls_.get() + group_begin, empty_control) != 0)
+        {
+            controls_[index] = empty_control;
+            ++growth_left_;
+        }
+        else
+            controls_[index] = deleted_control;
+        --size_;
+    }
+
+    void rehash_(std::size_t new_capacity)
+    {
+        std::unique_ptr<control_byte[]> old_controls = std::move(controls_);
+        std::unique_ptr<slot[]> old_slots = std::move(slots_);
+        const std::size_t old_capacity = capacity_;
+
+        controls_ = std::make_unique<control_byte[]>(new_capacity);
+        std::fill_n(controls_.get(), new_capacity, empty_control);
+        slots_ = std::make_unique<slot[]>(new_capacity);
+        capacity_ = new_capacity;
+        size_ = 0;
+        growth_left_ = max_load_(new_capacity);
+
+        for (std::size_t index = 0; index < old_capacity; ++index)
+        {
+            if (old_controls[index] >= 0)
+                insert_new_(old_slots[index].hash, old_slots[index].entry);
+        }
+    }
+
+    void destroy_entries_()
+    {
+        for (std::size_t index = 0; index < capacity_; ++index)
+        {
+            if (controls_[index] >= 0)
+                delete slots_[index].entry;
+        }
+    }
+
+    inline std::size_t next_full_index_(std::size_t index) const
+    {
+        while (index < capacity_ && controls_[index] < 0)
+            ++index;
+        return index;
+    }
+
+private:
+    std::unique_ptr<control_byte[]> controls_;
+    std::unique_ptr<slot[]> slots_;
+    std::size_t capacity_ = 0;
+    std::size_t size_ = 0;
+    std::size_t growth_left_ = 0;
+    [[no_unique_address]] hash_type hash_;
+    [[no_unique_address]] key_equal_type key_equal_;
+};
+
+} // namespace rsce
+} // namespace arba
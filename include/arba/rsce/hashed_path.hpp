@@ -0,0 +1,117 @@
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+inline namespace arba
+{
+namespace rsce
+{
+
+// View on the native string of a path.
+using path_string_view = std::basic_string_view<std::filesystem::path::value_type>;
+
+// Hash of the native string of a path, computable at compile time. It is the hash used by the dictionaries of the
+// resource stores. The string is hashed by words of 64 bits, each mixed by a multiplication, then the hash is
+// finalized as in MurmurHash3, so that its low and high bits both depend on every character.
+constexpr std::size_t hash_path_string(path_string_view path_string) noexcept
+{
+    using character_type = std::filesystem::path::value_type;
+    constexpr std::size_t character_bits = sizeof(character_type) * 8;
+    constexpr std::size_t characters_per_word = 64 / character_bits;
+    constexpr std::uint64_t multiplier = 0x9e3779b97f4a7c15ull;
+
+    std::uint64_t hash = 0xcbf29ce484222325ull ^ (path_string.size() * multiplier);
+    std::size_t index = 0;
+    if (!std::is_constant_evaluated() && std::endian::native == std::endian::little)
+    {
+        // Same words as below, read at once.
+        for (; index + characters_per_word <= path_string.size(); index += characters_per_word)
+        {
+            std::uint64_t word;
+            std::memcpy(&word, path_string.data() + index, sizeof(word));
+            hash = (hash ^ word) * multiplier;
+            hash ^= hash >> 29;
+        }
+    }
+    while (index < path_string.size())
+    {
+        std::uint64_t word = 0;
+        for (std::size_t i = 0; i < characters_per_word && index < path_string.size(); ++i, ++index)
+        {
+            using unsigned_character_type = std::make_unsigned_t<character_type>;
+            word |= static_cast<std::uint64_t>(static_cast<unsigned_character_type>(path_string[index]))
+                    << (i * character_bits);
+        }
+        hash = (hash ^ word) * multiplier;
+        hash ^= hash >> 29;
+    }
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdull;
+    hash ^= hash >> 33;
+    hash *= 0xc4ceb9fe1a85ec53ull;
+    hash ^= hash >> 33;
+    return static_cast<std::size_t>(hash);
+}
+
+// View on the native string of a path with its precomputed hash: a resource store looks it up without hashing it.
+class hashed_path_view
+{
+public:
+    constexpr hashed_path_view(path_string_view path_string, std::size_t hash) noexcept
+        : native_(path_string), hash_(hash)
+    {
+    }
+    constexpr explicit hashed_path_view(path_string_view path_string) noexcept
+        : hashed_path_view(path_string, hash_path_string(path_string))
+    {
+    }
+
+    inline constexpr path_string_view native() const noexcept { return native_; }
+    inline constexpr std::size_t hash() const noexcept { return hash_; }
+
+private:
+    path_string_view native_;
+    std::size_t hash_;
+};
+
+// Path with its precomputed hash, to be constructed once and looked up many times.
+class hashed_path
+{
+public:
+    hashed_path() : hashed_path(std::filesystem::path()) {}
+    explicit hashed_path(std::filesystem::path path) : path_(std::move(path)), hash_(hash_path_string(path_.native()))
+    {
+    }
+    explicit hashed_path(hashed_path_view path_view) : path_(path_view.native()), hash_(path_view.hash()) {}
+
+    inline const std::filesystem::path& path() const noexcept { return path_; }
+    inline path_string_view native() const noexcept { return path_.native(); }
+    inline std::size_t hash() const noexcept { return hash_; }
+
+    inline operator hashed_path_view() const noexcept { return hashed_path_view(path_.native(), hash_); }
+
+private:
+    std::filesystem::path path_;
+    std::size_t hash_;
+};
+
+namespace literals
+{
+// "RSC:/ui/font.ttf"_rsc is a hashed_path_view whose hash is computed at compile time. The string is in the native
+// encoding of paths (e.g. L"..."_rsc on Windows).
+consteval hashed_path_view operator""_rsc(const std::filesystem::path::value_type* path_string,
+                                          std::size_t length) noexcept
+{
+    return hashed_path_view(path_string_view(path_string, length));
+}
+} // namespace literals
+
+} // namespace rsce
+} // namespace arba
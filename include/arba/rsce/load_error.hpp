@@ -0,0 +1,72 @@
+#pragma once
+
+#include <exception>
+#include <filesystem>
+#include <system_error>
+#include <type_traits>
+#include <version>
+
+// Defined if the non-throwing API returning std::expected (try_get_shared(), try_load_resource_from_file()) is
+// available, i.e. if the standard library provides std::expected (C++23).
+#if defined(__cpp_lib_expected) && __cpp_lib_expected >= 202202L
+#define ARBA_RSCE_HAS_EXPECTED 1
+#endif
+
+inline namespace arba
+{
+namespace rsce
+{
+
+// Reasons why a resource was not loaded, other than the error codes of the filesystem.
+enum class load_errc
+{
+    // The resource rejected its file: its load_from_file() returned false, or its loader returned nullptr.
+    resource_not_loaded = 1,
+    // The loading threw an exception which is not a std::system_error.
+    exception_thrown,
+    // The path is in a resource pack mounted by a resource_manager, whose operation does not look up packs.
+    pack_path_not_supported,
+};
+
+const std::error_category& load_category() noexcept;
+
+inline std::error_code make_error_code(load_errc errc) noexcept
+{
+    return std::error_code(static_cast<int>(errc), load_category());
+}
+
+// Failure of a resource loading, returned by the non-throwing API.
+struct load_error
+{
+    // A load_errc, an error of the filesystem (e.g. std::errc::no_such_file_or_directory when the canonical path of
+    // the resource could not be made), or the error code returned by the load_from_file() of the resource.
+    std::error_code code;
+    std::filesystem::path path;
+
+    bool operator==(const load_error&) const = default;
+};
+
+// Returns the error code describing a failure of a loading which threw exception.
+inline std::error_code error_code_of(std::exception_ptr exception) noexcept
+{
+    try
+    {
+        std::rethrow_exception(std::move(exception));
+    }
+    catch (const std::system_error& error)
+    {
+        return error.code();
+    }
+    catch (...)
+    {
+    }
+    return make_error_code(load_errc::exception_thrown);
+}
+
+} // namespace rsce
+} // namespace arba
+
+template <>
+struct std::is_error_code_enum<arba::rsce::load_errc> : public std::true_type
+{
+};
@@ -1,22 +1,82 @@
 #pragma once
 
+#include "load_error.hpp"
 #include "load_resource_from_binary_stream.hpp"
+#include "load_resource_from_memory.hpp"
 #include "load_resource_from_text_stream.hpp"
+#include "mapped_file.hpp"
+#include "memory_stream.hpp"
 
+#include <cstddef>
 #include <filesystem>
 #include <fstream>
 #include <memory>
+#include <span>
+#include <system_error>
+#ifdef ARBA_RSCE_HAS_EXPECTED
+#include <expected>
+#endif
 
 inline namespace arba
 {
 namespace rsce
 {
 
+// Stream read by load_resource_from_file() for the stream loaders of a resource (see
+// load_resource_from_binary_stream() and load_resource_from_text_stream()).
+enum class stream_source
+{
+    // A std::ifstream on the file.
+    file_stream,
+    // A memory_istream on a memory mapping of the file: reading makes no system call and copies from the page cache
+    // only, and seekg() and tellg() are O(1). Line endings are not translated, even by text streams on Windows.
+    file_mapping,
+};
+
+namespace traits
+{
+// Stream source of the stream loaders of resource_type, to be specialized in namespace rsce::traits, e.g.:
+// template <> inline constexpr stream_source stream_source_v<mesh> = stream_source::file_mapping;
+template <class resource_type>
+inline constexpr stream_source stream_source_v = stream_source::file_stream;
+} // namespace traits
+
+namespace concepts
+{
+// Resource which is a view on its memory mapped file (e.g. mapped_resource): its map_file() is preferred to any other
+// loader by load_resource_from_file().
+template <class resource_type>
+concept file_mapped_resource = requires(const std::filesystem::path& fpath) {
+    { resource_type::map_file(fpath) } -> std::same_as<std::shared_ptr<resource_type>>;
+};
+} // namespace concepts
+
 // load_resource_from_file(path);
 
 template <class resource_type>
 std::shared_ptr<resource_type> load_resource_from_file(const std::filesystem::path& path) = delete;
 
+// A resource loadable from memory is preferred to the other loaders but map_file(): it reads a memory mapping of the
+// file, without any copy.
+template <class resource_type>
+    requires requires(std::span<const std::byte> bytes) {
+        { load_resource_from_memory<resource_type>(bytes) } -> std::same_as<std::shared_ptr<resource_type>>;
+    } && (!concepts::file_mapped_resource<resource_type>)
+std::shared_ptr<resource_type> load_resource_from_file(const std::filesystem::path& path)
+{
+    const mapped_file file(path);
+    return load_resource_from_memory<resource_type>(file.bytes());
+}
+
+// A resource which is a view on its memory mapped file (e.g. mapped_resource) maps its file itself, and its shared
+// pointer owns the mapping.
+template <class resource_type>
+    requires concepts::file_mapped_resource<resource_type>
+std::shared_ptr<resource_type> load_resource_from_file(const std::filesystem::path& path)
+{
+    return resource_type::map_file(path);
+}
+
 template <class resource_type>
     requires requires(resource_type& value, const std::filesystem::path& fpath) {
         { value.load_from_file(fpath) } -> std::convertible_to<bool>;
@@ -24,7 +84,9 @@ template <class resource_type>
                  { load_resource_from_binary_stream<resource_type>(stream) };
              }) && (!requires(std::istream& stream) {
                  { load_resource_from_text_stream<resource_type>(stream) };
-             })
+             }) && (!requires(std::span<const std::byte> bytes) {
+                 { load_resource_from_memory<resource_type>(bytes) };
+             }) && (!concepts::file_mapped_resource<resource_type>)
 std::shared_ptr<resource_type> load_resource_from_file(const std::filesystem::path& path)
 {
     if (std::shared_ptr rsc_sptr = std::make_shared<resource_type>(); rsc_sptr->load_from_file(path)) [[likely]]
@@ -39,7 +101,9 @@ template <class resource_type>
                  { load_resource_from_binary_stream<resource_type>(stream) };
              }) && (!requires(std::istream& stream) {
                  { load_resource_from_text_stream<resource_type>(stream) };
-             })
+             }) && (!requires(std::span<const std::byte> bytes) {
+                 { load_resource_from_memory<resource_type>(bytes) };
+             }) && (!concepts::file_mapped_resource<resource_type>)
 std::shared_ptr<resource_type> load_resource_from_file(const std::filesystem::path& path)
 {
     std::shared_ptr rsc_sptr = std::make_shared<resource_type>();
@@ -47,26 +111,68 @@ std::shared_ptr<resource_type> load_resource_from_file(const std::filesystem::pa
     return rsc_sptr;
 }
 
+// The error code is available with try_load_resource_from_file().
+template <class resource_type>
+    requires requires(resource_type& value, const std::filesystem::path& fpath) {
+        { value.load_from_file(fpath) } -> std::same_as<std::error_code>;
+    } && (!requires(std::istream& stream) {
+                 { load_resource_from_binary_stream<resource_type>(stream) };
+             }) && (!requires(std::istream& stream) {
+                 { load_resource_from_text_stream<resource_type>(stream) };
+             }) && (!requires(std::span<const std::byte> bytes) {
+                 { load_resource_from_memory<resource_type>(bytes) };
+             }) && (!concepts::file_mapped_resource<resource_type>)
+std::shared_ptr<resource_type> load_resource_from_file(const std::filesystem::path& path)
+{
+    if (std::shared_ptr rsc_sptr = std::make_shared<resource_type>(); !rsc_sptr->load_from_file(path)) [[likely]]
+        return rsc_sptr;
+    return std::shared_ptr<resource_type>();
+}
+
 template <class resource_type>
     requires requires(std::istream& stream) {
         { load_resource_from_binary_stream<resource_type>(stream) } -> std::same_as<std::shared_ptr<resource_type>>;
-    }
+    } && (!requires(std::span<const std::byte> bytes) {
+                 { load_resource_from_memory<resource_type>(bytes) };
+             }) && (!concepts::file_mapped_resource<resource_type>)
 std::shared_ptr<resource_type> load_resource_from_file(const std::filesystem::path& path)
 {
-    std::ifstream stream(path, std::ifstream::binary);
-    stream.exceptions(std::ifstream::failbit);
-    return load_resource_from_binary_stream<resource_type>(stream);
+    if constexpr (traits::stream_source_v<resource_type> == stream_source::file_mapping)
+    {
+        const mapped_file file(path);
+        memory_istream stream(file.bytes());
+        stream.exceptions(std::ifstream::failbit);
+        return load_resource_from_binary_stream<resource_type>(stream);
+    }
+    else
+    {
+        std::ifstream stream(path, std::ifstream::binary);
+        stream.exceptions(std::ifstream::failbit);
+        return load_resource_from_binary_stream<resource_type>(stream);
+    }
 }
 
 template <class resource_type>
     requires requires(std::istream& stream) {
         { load_resource_from_text_stream<resource_type>(stream) } -> std::same_as<std::shared_ptr<resource_type>>;
-    }
+    } && (!requires(std::span<const std::byte> bytes) {
+                 { load_resource_from_memory<resource_type>(bytes) };
+             }) && (!concepts::file_mapped_resource<resource_type>)
 std::shared_ptr<resource_type> load_resource_from_file(const std::filesystem::path& path)
 {
-    std::ifstream stream(path);
-    stream.exceptions(std::ifstream::failbit);
-    return load_resource_from_text_stream<resource_type>(stream);
+    if constexpr (traits::stream_source_v<resource_type> == stream_source::file_mapping)
+    {
+        const mapped_file file(path);
+        memory_istream stream(file.bytes());
+        stream.exceptions(std::ifstream::failbit);
+        return load_resource_from_text_stream<resource_type>(stream);
+    }
+    else
+    {
+        std::ifstream stream(path);
+        stream.exceptions(std::ifstream::failbit);
+        return load_resource_from_text_stream<resource_type>(stream);
+    }
 }
 
 // load_resource_from_file(path, resource_manager);
@@ -75,6 +181,19 @@ template <class resource_type, class resource_manager_type>
 std::shared_ptr<resource_type> load_resource_from_file(const std::filesystem::path& path,
                                                        resource_manager_type& rsc_manager) = delete;
 
+template <class resource_type, class resource_manager_type>
+    requires requires(std::span<const std::byte> bytes, resource_manager_type& rsc_manager) {
+        {
+            load_resource_from_memory<resource_type>(bytes, rsc_manager)
+        } -> std::same_as<std::shared_ptr<resource_type>>;
+    }
+std::shared_ptr<resource_type> load_resource_from_file(const std::filesystem::path& path,
+                                                       resource_manager_type& rsc_manager)
+{
+    const mapped_file file(path);
+    return load_resource_from_memory<resource_type>(file.bytes(), rsc_manager);
+}
+
 template <class resource_type, class resource_manager_type>
     requires requires(resource_type& value, const std::filesystem::path& fpath, resource_manager_type& rsc_manager) {
         { value.load_from_file(fpath, rsc_manager) } -> std::convertible_to<bool>;
@@ -82,6 +201,8 @@ template <class resource_type, class resource_manager_type>
                  { load_resource_from_binary_stream<resource_type>(stream, rsc_manager) };
              }) && (!requires(std::istream& stream, resource_manager_type& rsc_manager) {
                  { load_resource_from_text_stream<resource_type>(stream, rsc_manager) };
+             }) && (!requires(std::span<const std::byte> bytes, resource_manager_type& rsc_manager) {
+                 { load_resource_from_memory<resource_type>(bytes, rsc_manager) };
              })
 std::shared_ptr<resource_type> load_resource_from_file(const std::filesystem::path& path,
                                                        resource_manager_type& rsc_manager)
@@ -99,6 +220,8 @@ template <class resource_type, class resource_manager_type>
                  { load_resource_from_binary_stream<resource_type>(stream, rsc_manager) };
              }) && (!requires(std::istream& stream, resource_manager_type& rsc_manager) {
                  { load_resource_from_text_stream<resource_type>(stream, rsc_manager) };
+             }) && (!requires(std::span<const std::byte> bytes, resource_manager_type& rsc_manager) {
+                 { load_resource_from_memory<resource_type>(bytes, rsc_manager) };
              })
 std::shared_ptr<resource_type> load_resource_from_file(const std::filesystem::path& path,
                                                        resource_manager_type& rsc_manager)
@@ -108,18 +231,49 @@ std::shared_ptr<resource_type> load_resource_from_file(const std::filesystem::pa
     return rsc_sptr;
 }
 
+template <class resource_type, class resource_manager_type>
+    requires requires(resource_type& value, const std::filesystem::path& fpath, resource_manager_type& rsc_manager) {
+        { value.load_from_file(fpath, rsc_manager) } -> std::same_as<std::error_code>;
+    } && (!requires(std::istream& stream, resource_manager_type& rsc_manager) {
+                 { load_resource_from_binary_stream<resource_type>(stream, rsc_manager) };
+             }) && (!requires(std::istream& stream, resource_manager_type& rsc_manager) {
+                 { load_resource_from_text_stream<resource_type>(stream, rsc_manager) };
+             }) && (!requires(std::span<const std::byte> bytes, resource_manager_type& rsc_manager) {
+                 { load_resource_from_memory<resource_type>(bytes, rsc_manager) };
+             })
+std::shared_ptr<resource_type> load_resource_from_file(const std::filesystem::path& path,
+                                                       resource_manager_type& rsc_manager)
+{
+    if (std::shared_ptr rsc_sptr = std::make_shared<resource_type>(); !rsc_sptr->load_from_file(path, rsc_manager))
+        [[likely]]
+        return rsc_sptr;
+    return std::shared_ptr<resource_type>();
+}
+
 template <class resource_type, class resource_manager_type>
     requires requires(std::istream& stream, resource_manager_type& rsc_manager) {
         {
             load_resource_from_binary_stream<resource_type>(stream, rsc_manager)
         } -> std::same_as<std::shared_ptr<resource_type>>;
-    }
+    } && (!requires(std::span<const std::byte> bytes, resource_manager_type& rsc_manager) {
+                 { load_resource_from_memory<resource_type>(bytes, rsc_manager) };
+             })
 std::shared_ptr<resource_type> load_resource_from_file(const std::filesystem::path& path,
                                                        resource_manager_type& rsc_manager)
 {
-    std::ifstream stream(path, std::ifstream::binary);
-    stream.exceptions(std::ifstream::failbit);
-    return load_resource_from_binary_stream<resource_type>(stream, rsc_manager);
+    if constexpr (traits::stream_source_v<resource_type> == stream_source::file_mapping)
+    {
+        const mapped_file file(path);
+        memory_istream stream(file.bytes());
+        stream.exceptions(std::ifstream::failbit);
+        return load_resource_from_binary_stream<resource_type>(stream, rsc_manager);
+    }
+    else
+    {
+        std::ifstream stream(path, std::ifstream::binary);
+        stream.exceptions(std::ifstream::failbit);
+        return load_resource_from_binary_stream<resource_type>(stream, rsc_manager);
+    }
 }
 
 template <class resource_type, class resource_manager_type>
@@ -127,15 +281,127 @@ template <class resource_type, class resource_manager_type>
         {
             load_resource_from_text_stream<resource_type>(stream, rsc_manager)
         } -> std::same_as<std::shared_ptr<resource_type>>;
-    }
+    } && (!requires(std::span<const std::byte> bytes, resource_manager_type& rsc_manager) {
+                 { load_resource_from_memory<resource_type>(bytes, rsc_manager) };
+             })
 std::shared_ptr<resource_type> load_resource_from_file(const std::filesystem::path& path,
                                                        resource_manager_type& rsc_manager)
 {
-    std::ifstream stream(path);
-    stream.exceptions(std::ifstream::failbit);
-    return load_resource_from_text_stream<resource_type>(stream, rsc_manager);
+    if constexpr (traits::stream_source_v<resource_type> == stream_source::file_mapping)
+    {
+        const mapped_file file(path);
+        memory_istream stream(file.bytes());
+        stream.exceptions(std::ifstream::failbit);
+        return load_resource_from_text_stream<resource_type>(stream, rsc_manager);
+    }
+    else
+    {
+        std::ifstream stream(path);
+        stream.exceptions(std::ifstream::failbit);
+        return load_resource_from_text_stream<resource_type>(stream, rsc_manager);
+    }
+}
+
+// load_resource_from_file(path, error_code), load_resource_from_file(path, resource_manager, error_code):
+// As load_resource_from_file(), but a failure is stored in error_code and nullptr is returned instead of thrown. A
+// resource whose load_from_file() returns a std::error_code or a bool fails without any exception.
+
+template <class resource_type>
+std::shared_ptr<resource_type> load_resource_from_file(const std::filesystem::path& path, std::error_code& error_code)
+{
+    error_code.clear();
+    try
+    {
+        if constexpr (requires(resource_type& value) {
+                          { value.load_from_file(path) } -> std::same_as<std::error_code>;
+                      } && !requires(std::istream& stream) {
+                          { load_resource_from_binary_stream<resource_type>(stream) };
+                      } && !requires(std::istream& stream) {
+                          { load_resource_from_text_stream<resource_type>(stream) };
+                      } && !requires(std::span<const std::byte> bytes) {
+                          { load_resource_from_memory<resource_type>(bytes) };
+                      } && !concepts::file_mapped_resource<resource_type>)
+        {
+            std::shared_ptr rsc_sptr = std::make_shared<resource_type>();
+            if (error_code = rsc_sptr->load_from_file(path); !error_code) [[likely]]
+                return rsc_sptr;
+        }
+        else
+        {
+            if (std::shared_ptr rsc_sptr = load_resource_from_file<resource_type>(path)) [[likely]]
+                return rsc_sptr;
+            error_code = load_errc::resource_not_loaded;
+        }
+    }
+    catch (...)
+    {
+        error_code = error_code_of(std::current_exception());
+    }
+    return std::shared_ptr<resource_type>();
+}
+
+template <class resource_type, class resource_manager_type>
+std::shared_ptr<resource_type> load_resource_from_file(const std::filesystem::path& path,
+                                                       resource_manager_type& rsc_manager, std::error_code& error_code)
+{
+    error_code.clear();
+    try
+    {
+        if constexpr (requires(resource_type& value) {
+                          { value.load_from_file(path, rsc_manager) } -> std::same_as<std::error_code>;
+                      } && !requires(std::istream& stream) {
+                          { load_resource_from_binary_stream<resource_type>(stream, rsc_manager) };
+                      } && !requires(std::istream& stream) {
+                          { load_resource_from_text_stream<resource_type>(stream, rsc_manager) };
+                      } && !requires(std::span<const std::byte> bytes) {
+                          { load_resource_from_memory<resource_type>(bytes, rsc_manager) };
+                      })
+        {
+            std::shared_ptr rsc_sptr = std::make_shared<resource_type>();
+            if (error_code = rsc_sptr->load_from_file(path, rsc_manager); !error_code) [[likely]]
+                return rsc_sptr;
+        }
+        else
+        {
+            if (std::shared_ptr rsc_sptr = load_resource_from_file<resource_type>(path, rsc_manager)) [[likely]]
+                return rsc_sptr;
+            error_code = load_errc::resource_not_loaded;
+        }
+    }
+    catch (...)
+    {
+        error_code = error_code_of(std::current_exception());
+    }
+    return std::shared_ptr<resource_type>();
 }
 
+#ifdef ARBA_RSCE_HAS_EXPECTED
+
+// try_load_resource_from_file(path), try_load_resource_from_file(path, resource_manager):
+// As load_resource_from_file(path, error_code), but the failure is returned.
+
+template <class resource_type>
+std::expected<std::shared_ptr<resource_type>, load_error>
+try_load_resource_from_file(const std::filesystem::path& path)
+{
+    std::error_code error_code;
+    if (std::shared_ptr rsc_sptr = load_resource_from_file<resource_type>(path, error_code)) [[likely]]
+        return rsc_sptr;
+    return std::unexpected(load_error{ error_code, path });
+}
+
+template <class resource_type, class resource_manager_type>
+std::expected<std::shared_ptr<resource_type>, load_error>
+try_load_resource_from_file(const std::filesystem::path& path, resource_manager_type& rsc_manager)
+{
+    std::error_code error_code;
+    if (std::shared_ptr rsc_sptr = load_resource_from_file<resource_type>(path, rsc_manager, error_code)) [[likely]]
+        return rsc_sptr;
+    return std::unexpected(load_error{ error_code, path });
+}
+
+#endif
+
 namespace concepts
 {
 template <class resource_type>
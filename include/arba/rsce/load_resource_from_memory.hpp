@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <span>
+
+inline namespace arba
+{
+namespace rsce
+{
+
+// The bytes are valid only during the call: the resource copies what it keeps.
+
+template <class resource_type>
+std::shared_ptr<resource_type> load_resource_from_memory(std::span<const std::byte> bytes) = delete;
+
+template <class resource_type>
+    requires requires(resource_type& value, std::span<const std::byte> bytes) {
+        { value.load_from_memory(bytes) } -> std::convertible_to<bool>;
+    }
+std::shared_ptr<resource_type> load_resource_from_memory(std::span<const std::byte> bytes)
+{
+    if (std::shared_ptr rsc_sptr = std::make_shared<resource_type>(); rsc_sptr->load_from_memory(bytes)) [[likely]]
+        return rsc_sptr;
+    return std::shared_ptr<resource_type>();
+}
+
+template <class resource_type>
+    requires requires(resource_type& value, std::span<const std::byte> bytes) {
+        { value.load_from_memory(bytes) } -> std::same_as<void>;
+    }
+std::shared_ptr<resource_type> load_resource_from_memory(std::span<const std::byte> bytes)
+{
+    std::shared_ptr rsc_sptr = std::make_shared<resource_type>();
+    rsc_sptr->load_from_memory(bytes);
+    return rsc_sptr;
+}
+
+template <class resource_type, class resource_manager_type>
+std::shared_ptr<resource_type> load_resource_from_memory(std::span<const std::byte> bytes,
+                                                         resource_manager_type& rsc_manager) = delete;
+
+template <class resource_type, class resource_manager_type>
+    requires requires(resource_type& value, std::span<const std::byte> bytes, resource_manager_type& rsc_manager) {
+        { value.load_from_memory(bytes, rsc_manager) } -> std::convertible_to<bool>;
+    }
+std::shared_ptr<resource_type> load_resource_from_memory(std::span<const std::byte> bytes,
+                                                         resource_manager_type& rsc_manager)
+{
+    if (std::shared_ptr rsc_sptr = std::make_shared<resource_type>(); rsc_sptr->load_from_memory(bytes, rsc_manager))
+        [[likely]]
+        return rsc_sptr;
+    return std::shared_ptr<resource_type>();
+}
+
+template <class resource_type, class resource_manager_type>
+    requires requires(resource_type& value, std::span<const std::byte> bytes, resource_manager_type& rsc_manager) {
+        { value.load_from_memory(bytes, rsc_manager) } -> std::same_as<void>;
+    }
+std::shared_ptr<resource_type> load_resource_from_memory(std::span<const std::byte> bytes,
+                                                         resource_manager_type& rsc_manager)
+{
+    std::shared_ptr rsc_sptr = std::make_shared<resource_type>();
+    rsc_sptr->load_from_memory(bytes, rsc_manager);
+    return rsc_sptr;
+}
+
+} // namespace rsce
+} // namespace arba
@@ -0,0 +1,116 @@
+#pragma once
+
+#include "load_error.hpp"
+#include "load_resource_from_binary_stream.hpp"
+#include "load_resource_from_memory.hpp"
+#include "load_resource_from_text_stream.hpp"
+#include "memory_stream.hpp"
+#include "resource_pack.hpp"
+
+#include <cstddef>
+#include <istream>
+#include <memory>
+#include <span>
+#include <string_view>
+#include <system_error>
+
+inline namespace arba
+{
+namespace rsce
+{
+
+// Loads a resource from an entry of a resource pack, with its memory loader, or else with its binary or text stream
+// loader reading a memory_istream on the bytes of the entry. Throws std::filesystem::filesystem_error if the pack
+// has no such entry. Given a resource manager, the loaders taking it are preferred.
+
+namespace concepts
+{
+template <class resource_type>
+concept pack_loadable_resource =
+    requires(std::span<const std::byte> bytes) { load_resource_from_memory<resource_type>(bytes); }
+    || requires(std::istream& stream) { load_resource_from_binary_stream<resource_type>(stream); }
+    || requires(std::istream& stream) { load_resource_from_text_stream<resource_type>(stream); };
+
+template <class resource_type, class resource_manager_type>
+concept pack_loadable_with_manager_resource =
+    requires(std::span<const std::byte> bytes, resource_manager_type& rsc_manager) {
+        load_resource_from_memory<resource_type>(bytes, rsc_manager);
+    } || requires(std::istream& stream, resource_manager_type& rsc_manager) {
+        load_resource_from_binary_stream<resource_type>(stream, rsc_manager);
+    } || requires(std::istream& stream, resource_manager_type& rsc_manager) {
+        load_resource_from_text_stream<resource_type>(stream, rsc_manager);
+    };
+} // namespace concepts
+
+template <class resource_type>
+    requires concepts::pack_loadable_resource<resource_type>
+std::shared_ptr<resource_type> load_resource_from_pack(const resource_pack& pack, std::string_view entry_path)
+{
+    const std::span<const std::byte> bytes = pack.at(entry_path);
+    if constexpr (requires { load_resource_from_memory<resource_type>(bytes); })
+        return load_resource_from_memory<resource_type>(bytes);
+    else
+    {
+        memory_istream stream(bytes);
+        stream.exceptions(std::istream::failbit);
+        if constexpr (requires { load_resource_from_binary_stream<resource_type>(stream); })
+            return load_resource_from_binary_stream<resource_type>(stream);
+        else
+            return load_resource_from_text_stream<resource_type>(stream);
+    }
+}
+
+template <class resource_type, class resource_manager_type>
+    requires concepts::pack_loadable_with_manager_resource<resource_type, resource_manager_type>
+             || concepts::pack_loadable_resource<resource_type>
+std::shared_ptr<resource_type> load_resource_from_pack(const resource_pack& pack, std::string_view entry_path,
+                                                       resource_manager_type& rsc_manager)
+{
+    if constexpr (!concepts::pack_loadable_with_manager_resource<resource_type, resource_manager_type>)
+        return load_resource_from_pack<resource_type>(pack, entry_path);
+    else
+    {
+        const std::span<const std::byte> bytes = pack.at(entry_path);
+        if constexpr (requires { load_resource_from_memory<resource_type>(bytes, rsc_manager); })
+            return load_resource_from_memory<resource_type>(bytes, rsc_manager);
+        else
+        {
+            memory_istream stream(bytes);
+            stream.exceptions(std::istream::failbit);
+            if constexpr (requires { load_resource_from_binary_stream<resource_type>(stream, rsc_manager); })
+                return load_resource_from_binary_stream<resource_type>(stream, rsc_manager);
+            else
+                return load_resource_from_text_stream<resource_type>(stream, rsc_manager);
+        }
+    }
+}
+
+// As load_resource_from_pack(), but a failure is stored in error_code and nullptr is returned instead of thrown. A
+// missing entry costs no exception.
+template <class resource_type, class resource_manager_type>
+    requires concepts::pack_loadable_with_manager_resource<resource_type, resource_manager_type>
+             || concepts::pack_loadable_resource<resource_type>
+std::shared_ptr<resource_type> load_resource_from_pack(const resource_pack& pack, std::string_view entry_path,
+                                                       resource_manager_type& rsc_manager, std::error_code& error_code)
+{
+    error_code.clear();
+    if (!pack.find(entry_path)) [[unlikely]]
+    {
+        error_code = std::make_error_code(std::errc::no_such_file_or_directory);
+        return std::shared_ptr<resource_type>();
+    }
+    try
+    {
+        if (std::shared_ptr rsc_sptr = load_resource_from_pack<resource_type>(pack, entry_path, rsc_manager)) [[likely]]
+            return rsc_sptr;
+        error_code = load_errc::resource_not_loaded;
+    }
+    catch (...)
+    {
+        error_code = error_code_of(std::current_exception());
+    }
+    return std::shared_ptr<resource_type>();
+}
+
+} // namespace rsce
+} // namespace arba
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <functional>
+#include <utility>
+
+inline namespace arba
+{
+namespace rsce
+{
+
+namespace concepts
+{
+template <class executor_type>
+concept executor = requires(executor_type& executor, std::function<void()> task) { executor.submit(std::move(task)); };
+} // namespace concepts
+
+// Executor of the asynchronous loadings of a resource manager.
+class loader_executor
+{
+public:
+    virtual ~loader_executor() = default;
+
+    virtual void submit(std::function<void()> task) = 0;
+
+    // Runs one pending task on the calling thread, if there is one.
+    virtual bool try_run_pending_task() { return false; }
+
+    // Returns the executor owning the calling thread, or nullptr if the calling thread belongs to no executor.
+    static loader_executor* current_thread_executor() noexcept;
+
+protected:
+    static void set_current_thread_executor_(loader_executor* executor) noexcept;
+};
+
+} // namespace rsce
+} // namespace arba
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "loader_executor.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+inline namespace arba
+{
+namespace rsce
+{
+
+// Work-stealing thread pool. Each thread has its own task queue: tasks submitted by a thread of the pool (nested
+// loadings) are pushed in its queue and popped in LIFO order, while tasks submitted by other threads are pushed in a
+// shared queue. An idle thread steals the oldest task of the other queues.
+class loader_thread_pool : public loader_executor
+{
+public:
+    static std::size_t default_number_of_threads();
+
+    // Starts at least one thread, even if number_of_threads is 0.
+    explicit loader_thread_pool(std::size_t number_of_threads = default_number_of_threads());
+    loader_thread_pool(const loader_thread_pool&) = delete;
+    loader_thread_pool& operator=(const loader_thread_pool&) = delete;
+    // Runs the pending tasks, then joins the threads.
+    virtual ~loader_thread_pool() override;
+
+    virtual void submit(std::function<void()> task) override;
+    virtual bool try_run_pending_task() override;
+
+    inline std::size_t number_of_threads() const { return threads_.size(); }
+
+private:
+    struct alignas(64) task_queue
+    {
+        std::deque<std::function<void()>> tasks;
+        std::mutex mutex;
+    };
+
+    void run_(std::size_t thread_index);
+    bool try_pop_task_(std::function<void()>& task);
+    static bool try_pop_front_(task_queue& queue, std::function<void()>& task);
+    static bool try_pop_back_(task_queue& queue, std::function<void()>& task);
+
+private:
+    std::unique_ptr<task_queue[]> thread_queues_;
+    task_queue shared_queue_;
+    std::atomic_size_t number_of_pending_tasks_ = 0;
+    std::mutex sleep_mutex_;
+    std::condition_variable sleep_condition_;
+    bool stopping_ = false;
+    std::vector<std::jthread> threads_;
+};
+
+} // namespace rsce
+} // namespace arba
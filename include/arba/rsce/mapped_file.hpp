@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <span>
+#include <system_error>
+
+inline namespace arba
+{
+namespace rsce
+{
+
+// Read-only memory mapping of a whole file. The pages are read from the file when they are first accessed, and the
+// mapped bytes stay valid until the mapped_file is destroyed or assigned. An empty file is mapped to an empty span.
+class mapped_file
+{
+public:
+    mapped_file() = default;
+    // Throws std::filesystem::filesystem_error if the file cannot be mapped.
+    explicit mapped_file(const std::filesystem::path& fpath);
+    mapped_file(const std::filesystem::path& fpath, std::error_code& error_code) noexcept;
+    mapped_file(mapped_file&& other) noexcept;
+    mapped_file& operator=(mapped_file&& other) noexcept;
+    mapped_file(const mapped_file&) = delete;
+    mapped_file& operator=(const mapped_file&) = delete;
+    ~mapped_file();
+
+    inline std::span<const std::byte> bytes() const noexcept { return std::span<const std::byte>(data_, size_); }
+    inline const std::byte* data() const noexcept { return data_; }
+    inline std::size_t size() const noexcept { return size_; }
+
+private:
+    void unmap_() noexcept;
+
+    const std::byte* data_ = nullptr;
+    std::size_t size_ = 0;
+};
+
+} // namespace rsce
+} // namespace arba
@@ -0,0 +1,75 @@
+#pragma once
+
+#include "mapped_file.hpp"
+
+#include <cstddef>
+#include <filesystem>
+#include <memory>
+#include <span>
+#include <system_error>
+#include <type_traits>
+
+inline namespace arba
+{
+namespace rsce
+{
+
+// Resource which is a view on the elements stored in its file (e.g. a lookup table or a baked mesh), read in place
+// from a memory mapping of the file. Its shared pointer owns the mapping, so that the elements stay mapped while the
+// resource is used: the memory of the resource is then page cache, shared with the other processes mapping the same
+// file, instead of a private copy. The file must be a sequence of element_type, in the representation of the target.
+template <class element_type>
+class mapped_resource
+{
+    static_assert(std::is_trivially_copyable_v<element_type>, "The elements are read from the file as they are.");
+
+public:
+    using value_type = element_type;
+    using const_iterator = typename std::span<const element_type>::iterator;
+
+    // Maps the file, and returns its resource. Throws std::filesystem::filesystem_error if the file cannot be mapped
+    // or if its size is not a multiple of the size of element_type. Called by load_resource_from_file().
+    static std::shared_ptr<mapped_resource> map_file(const std::filesystem::path& fpath);
+
+    inline std::span<const element_type> elements() const noexcept { return elements_; }
+    inline std::span<const std::byte> bytes() const noexcept { return std::as_bytes(elements_); }
+    inline const element_type* data() const noexcept { return elements_.data(); }
+    inline std::size_t size() const noexcept { return elements_.size(); }
+    inline bool empty() const noexcept { return elements_.empty(); }
+    inline const element_type& operator[](std::size_t index) const noexcept { return elements_[index]; }
+    inline const_iterator begin() const noexcept { return elements_.begin(); }
+    inline const_iterator end() const noexcept { return elements_.end(); }
+
+private:
+    std::span<const element_type> elements_;
+};
+
+// Bytes of a file, read in place from a memory mapping of the file.
+using mapped_blob = mapped_resource<std::byte>;
+
+template <class element_type>
+std::shared_ptr<mapped_resource<element_type>> mapped_resource<element_type>::map_file(
+    const std::filesystem::path& fpath)
+{
+    // The mapping and the resource are allocated together, and the returned pointer shares their ownership.
+    struct mapping
+    {
+        mapped_file file;
+        mapped_resource resource;
+    };
+
+    std::shared_ptr mapping_sptr = std::make_shared<mapping>(mapped_file(fpath), mapped_resource());
+    const std::span<const std::byte> bytes = mapping_sptr->file.bytes();
+    if (bytes.size() % sizeof(element_type) != 0) [[unlikely]]
+    {
+        throw std::filesystem::filesystem_error("file size is not a multiple of the element size", fpath,
+                                                std::make_error_code(std::errc::invalid_argument));
+    }
+    // The mapping is aligned on a page.
+    mapping_sptr->resource.elements_ = std::span<const element_type>(
+        reinterpret_cast<const element_type*>(bytes.data()), bytes.size() / sizeof(element_type));
+    return std::shared_ptr<mapped_resource>(mapping_sptr, &mapping_sptr->resource);
+}
+
+} // namespace rsce
+} // namespace arba
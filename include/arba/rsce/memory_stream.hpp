@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstddef>
+#include <istream>
+#include <span>
+#include <streambuf>
+
+inline namespace arba
+{
+namespace rsce
+{
+
+// Read-only stream buffer over bytes in memory, e.g. a mapped file (see mapped_file). Its get area is the whole byte
+// range, so that reading copies directly from it, and seeking is O(1).
+class memory_streambuf : public std::streambuf
+{
+public:
+    explicit memory_streambuf(std::span<const std::byte> bytes);
+
+protected:
+    virtual pos_type seekoff(off_type offset, std::ios_base::seekdir direction,
+                             std::ios_base::openmode mode = std::ios_base::in) override;
+    virtual pos_type seekpos(pos_type position, std::ios_base::openmode mode = std::ios_base::in) override;
+    virtual std::streamsize showmanyc() override;
+};
+
+// Input stream over bytes in memory, which must outlive it. Line endings are not translated, even on Windows.
+class memory_istream : public std::istream
+{
+public:
+    explicit memory_istream(std::span<const std::byte> bytes);
+
+private:
+    memory_streambuf streambuf_;
+};
+
+} // namespace rsce
+} // namespace arba
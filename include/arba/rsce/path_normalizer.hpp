@@ -0,0 +1,47 @@
+#pragma once
+
+#include <filesystem>
+#include <system_error>
+#include <type_traits>
+
+inline namespace arba
+{
+namespace rsce
+{
+
+// Path normalizers compute the key of a resource in its store, so that different spellings of the same path share
+// the same resource.
+
+// Resolves links, "." and ".." in the filesystem: the resource file must exist.
+struct canonical_path_normalizer
+{
+    static constexpr bool accesses_filesystem = true;
+
+    inline static std::filesystem::path normalize(const std::filesystem::path& rsc_path, std::error_code& error_code)
+    {
+        return std::filesystem::canonical(rsc_path, error_code);
+    }
+};
+
+// Removes "." and ".." lexically, without accessing the filesystem: links are not resolved and a missing file is
+// only detected when loading it. Relative paths are resolved against root_type::root() if root_type is not void,
+// against the current directory otherwise.
+template <class root_type = void>
+struct lexical_path_normalizer
+{
+    static constexpr bool accesses_filesystem = false;
+
+    inline static std::filesystem::path normalize(const std::filesystem::path& rsc_path, std::error_code& error_code)
+    {
+        error_code.clear();
+        if (rsc_path.is_absolute())
+            return rsc_path.lexically_normal();
+        if constexpr (std::is_void_v<root_type>)
+            return std::filesystem::absolute(rsc_path, error_code).lexically_normal();
+        else
+            return (root_type::root() / rsc_path).lexically_normal();
+    }
+};
+
+} // namespace rsce
+} // namespace arba
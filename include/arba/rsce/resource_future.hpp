@@ -0,0 +1,90 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+
+inline namespace arba
+{
+namespace rsce
+{
+
+// Queued loading of a resource, which is run at most once: either by a loader thread or, if it has not started
+// yet, by the first thread waiting for its result.
+class resource_loading_task
+{
+public:
+    explicit resource_loading_task(std::function<void()> function) : function_(std::move(function)) {}
+
+    // Returns false if the task was already started by another thread.
+    inline bool try_run()
+    {
+        if (started_.test_and_set(std::memory_order_acq_rel))
+            return false;
+        std::function<void()> function = std::move(function_);
+        function();
+        return true;
+    }
+
+private:
+    std::function<void()> function_;
+    std::atomic_flag started_;
+};
+
+template <class resource_type>
+class resource_future
+{
+public:
+    using resource = resource_type;
+    using resource_sptr = std::shared_ptr<resource>;
+
+    resource_future() = default;
+    explicit resource_future(std::shared_future<resource_sptr> future,
+                             std::shared_ptr<resource_loading_task> task = nullptr)
+        : future_(std::move(future)), task_(std::move(task))
+    {
+    }
+
+    inline static resource_future make_ready(resource_sptr rsc_sptr)
+    {
+        std::promise<resource_sptr> rsc_promise;
+        rsc_promise.set_value(std::move(rsc_sptr));
+        return resource_future(rsc_promise.get_future().share());
+    }
+
+    inline static resource_future make_exceptional(std::exception_ptr exception)
+    {
+        std::promise<resource_sptr> rsc_promise;
+        rsc_promise.set_exception(std::move(exception));
+        return resource_future(rsc_promise.get_future().share());
+    }
+
+    inline bool valid() const { return future_.valid(); }
+    inline bool is_ready() const { return future_.wait_for(std::chrono::seconds(0)) == std::future_status::ready; }
+
+    // Runs the loading task if no thread has started it yet, otherwise blocks until the thread running it is done.
+    // Other pending tasks are not run meanwhile: one of them could join a loading lower on the stack of the calling
+    // thread, which would then wait for itself.
+    inline void wait() const
+    {
+        if (task_ && task_->try_run())
+            return;
+        future_.wait();
+    }
+
+    inline const resource_sptr& get() const
+    {
+        wait();
+        return future_.get();
+    }
+
+private:
+    std::shared_future<resource_sptr> future_;
+    std::shared_ptr<resource_loading_task> task_;
+};
+
+} // namespace rsce
+} // namespace arba
@@ -0,0 +1,111 @@
+#pragma once
+
+#include "resource_id.hpp"
+
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+
+inline namespace arba
+{
+namespace rsce
+{
+
+// Slot of a path interned in a resource store, which mirrors the resource stored with this path as key. Its
+// generation is incremented each time the resource is replaced, which invalidates the handles on the previous one.
+template <class resource_type>
+struct resource_slot
+{
+    // Canonical path, never modified once the slot is published.
+    std::filesystem::path path;
+    std::shared_ptr<resource_type> rsc_sptr;
+    std::atomic<resource_type*> rsc_ptr = nullptr;
+    std::atomic_uint32_t generation = 0;
+    std::mutex mutex;
+
+    // Must be called with mutex locked. Returns the previous resource, which the caller must release once mutex is
+    // unlocked: a reader which has just loaded its pointer must not see it destroyed under the lock.
+    [[nodiscard]] inline std::shared_ptr<resource_type> assign(std::shared_ptr<resource_type> new_rsc_sptr)
+    {
+        std::shared_ptr<resource_type> old_rsc_sptr = std::move(rsc_sptr);
+        generation.store(generation.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        // A reader which sees the new pointer sees the new generation too.
+        rsc_ptr.store(new_rsc_sptr.get(), std::memory_order_release);
+        rsc_sptr = std::move(new_rsc_sptr);
+        return old_rsc_sptr;
+    }
+};
+
+// Lightweight reference to a resource of a store (see default_resource_store::get_handle()), which does not own it.
+// Dereferencing checks that the resource has not been replaced or removed since the handle was created, with two
+// plain loads and no reference count update. The resource stays alive as long as it is stored: pin() returns a
+// shared pointer when the resource must outlive a concurrent replacement.
+//
+// The pointer returned by get() (or used by operator* and operator->) is only valid until the next set() or remove()
+// of the resource: a resource used by a thread while another one may replace it must be pinned first.
+template <class resource_type>
+class resource_handle
+{
+public:
+    using resource = resource_type;
+    using resource_sptr = std::shared_ptr<resource>;
+
+    resource_handle() = default;
+    resource_handle(resource_slot<resource_type>& slot, resource_id<resource_type> rsc_id, std::uint32_t generation)
+        : slot_(&slot), id_(rsc_id), generation_(generation)
+    {
+    }
+
+    inline resource_id<resource_type> id() const { return id_; }
+
+    // Returns nullptr if the resource was replaced or removed. The returned pointer is valid until the next
+    // replacement or removal of the resource, see pin().
+    inline resource_type* get() const noexcept
+    {
+        if (!slot_) [[unlikely]]
+            return nullptr;
+        resource_type* rsc_ptr = slot_->rsc_ptr.load(std::memory_order_acquire);
+        if (slot_->generation.load(std::memory_order_relaxed) != generation_) [[unlikely]]
+            return nullptr;
+        return rsc_ptr;
+    }
+
+    inline bool valid() const noexcept { return get() != nullptr; }
+    inline explicit operator bool() const noexcept { return valid(); }
+
+    inline resource_type& operator*() const noexcept
+    {
+        resource_type* rsc_ptr = get();
+        assert(rsc_ptr);
+        return *rsc_ptr;
+    }
+
+    inline resource_type* operator->() const noexcept
+    {
+        resource_type* rsc_ptr = get();
+        assert(rsc_ptr);
+        return rsc_ptr;
+    }
+
+    // Returns a shared pointer on the resource, or nullptr if the resource was replaced or removed.
+    inline resource_sptr pin() const
+    {
+        if (!slot_) [[unlikely]]
+            return nullptr;
+        std::lock_guard lock(slot_->mutex);
+        if (slot_->generation.load(std::memory_order_relaxed) != generation_)
+            return nullptr;
+        return slot_->rsc_sptr;
+    }
+
+private:
+    resource_slot<resource_type>* slot_ = nullptr;
+    resource_id<resource_type> id_;
+    std::uint32_t generation_ = 0;
+};
+
+} // namespace rsce
+} // namespace arba
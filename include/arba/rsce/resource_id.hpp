@@ -0,0 +1,35 @@
+#pragma once
+
+#include <compare>
+#include <cstdint>
+#include <limits>
+
+inline namespace arba
+{
+namespace rsce
+{
+
+// Identifier of a resource path interned in a resource store (see default_resource_store::intern()). It indexes the
+// slot of the path in its store, and stays valid for the lifetime of the store, whatever happens to the resource.
+template <class resource_type>
+class resource_id
+{
+public:
+    using resource = resource_type;
+
+    resource_id() = default;
+    explicit resource_id(std::uint32_t index) : index_(index) {}
+
+    inline std::uint32_t index() const { return index_; }
+    inline bool valid() const { return index_ != invalid_index; }
+
+    auto operator<=>(const resource_id&) const = default;
+
+private:
+    static constexpr std::uint32_t invalid_index = std::numeric_limits<std::uint32_t>::max();
+
+    std::uint32_t index_ = invalid_index;
+};
+
+} // namespace rsce
+} // namespace arba
@@ -1,9 +1,21 @@
 #pragma once
 
 #include "basic_resource_manager.hpp"
+#include "load_error.hpp"
+#include "resource_pack.hpp"
 
 #include <arba/vlfs/vlfs.hpp>
 
+#include <exception>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+#include <vector>
+
 inline namespace arba
 {
 namespace rsce
@@ -13,13 +25,56 @@ class resource_manager : public basic_resource_manager
 {
 public:
     explicit resource_manager(vlfs::virtual_filesystem& vlfs) : vlfs_(&vlfs) {}
+    // At least one loader thread is started, even if number_of_loader_threads is 0.
+    resource_manager(vlfs::virtual_filesystem& vlfs, std::size_t number_of_loader_threads)
+        : basic_resource_manager(number_of_loader_threads), vlfs_(&vlfs)
+    {
+    }
+    resource_manager(vlfs::virtual_filesystem& vlfs, std::shared_ptr<loader_executor> executor)
+        : basic_resource_manager(std::move(executor)), vlfs_(&vlfs)
+    {
+    }
 
     inline const vlfs::virtual_filesystem& virtual_filesystem() const { return *vlfs_; }
     inline vlfs::virtual_filesystem& virtual_filesystem() { return *vlfs_; }
 
+    // Mounts a resource pack as the root root_name: a resource path starting with root_name and ":/" (e.g.
+    // "PACK:/ui/font.ttf") is then an entry path of the pack, looked up in its index without accessing the filesystem,
+    // and the key of its resource. It must be spelled as in the pack. A pack hides the virtual root of the same name,
+    // and replaces the pack previously mounted as root_name.
+    // get(), get_shared() and try_get_shared() look up resources in packs. The other operations reject a path in a
+    // pack with a std::filesystem::filesystem_error of code load_errc::pack_path_not_supported, or fail as their
+    // nothrow overload does.
+    // Packs are mounted before the manager is shared with other threads, and before any resource is looked up, stored
+    // or loaded: the mounted packs are then never modified while they are read, and no resource of a replaced pack is
+    // kept under its path. Throws std::logic_error otherwise.
+    inline void mount_pack(std::string_view root_name, std::shared_ptr<const resource_pack> pack)
+    {
+        if (has_resource_stores_()) [[unlikely]]
+            throw std::logic_error("Resource packs must be mounted before any resource is looked up.");
+        std::filesystem::path::string_type prefix = std::filesystem::path(std::string(root_name) + ":/").native();
+        for (mounted_pack& mounted : packs_)
+        {
+            if (mounted.prefix == prefix)
+            {
+                mounted.pack = std::move(pack);
+                return;
+            }
+        }
+        packs_.push_back(mounted_pack{ std::move(prefix), std::move(pack) });
+    }
+
+    // Throws std::filesystem::filesystem_error if the file cannot be mapped or is not a valid pack.
+    inline void mount_pack(std::string_view root_name, const std::filesystem::path& pack_path)
+    {
+        mount_pack(root_name, std::make_shared<const resource_pack>(pack_path));
+    }
+
     template <class resource>
     inline std::shared_ptr<resource> get_shared(const std::filesystem::path& rsc_path)
     {
+        if (const mounted_pack* pack = find_pack_(rsc_path.native()))
+            return get_shared_from_pack_<resource>(*pack, rsc_path);
         if (vlfs::virtual_filesystem::path_components path_comps = vlfs_->extract_components(rsc_path); path_comps)
         {
             return basic_resource_manager::get_shared<resource>(vlfs_->real_path(path_comps));
@@ -30,14 +85,56 @@ public:
     template <class resource>
     inline std::shared_ptr<resource> get_shared(std::filesystem::path&& rsc_path)
     {
+        if (const mounted_pack* pack = find_pack_(rsc_path.native()))
+            return get_shared_from_pack_<resource>(*pack, rsc_path);
         std::filesystem::path real_path(std::move(rsc_path));
         vlfs_->convert_to_real_path(real_path);
         return this->get_or_create_resource_store_<resource>().get_shared(real_path, *this);
     }
 
+    // A cache hit constructs no path. A virtual path is resolved by the virtual filesystem on its first lookup, then
+    // cached as a spelling of its real path (see default_resource_store::cache_canonical_path()), until
+    // invalidate_canonical_paths() is called.
+    template <class resource, concepts::path_string string_type>
+    inline std::shared_ptr<resource> get_shared(const string_type& rsc_path)
+    {
+        const path_string_view rsc_path_view = rsc_path;
+        return get_shared_spelling_<resource>(rsc_path_view, rsc_path_view);
+    }
+
+    // As above, without hashing rsc_path on a cache hit (see hashed_path).
+    template <class resource>
+    inline std::shared_ptr<resource> get_shared(hashed_path_view rsc_path)
+    {
+        return get_shared_spelling_<resource>(rsc_path, rsc_path.native());
+    }
+
+    template <class resource>
+    inline std::shared_ptr<resource> get_shared(resource_id<resource> rsc_id)
+    {
+        return this->get_or_create_resource_store_<resource>().get_shared(rsc_id, *this);
+    }
+
+    template <class resource>
+    inline resource_id<resource> intern(const std::filesystem::path& rsc_path)
+    {
+        return basic_resource_manager::intern<resource>(real_path_(rsc_path));
+    }
+
+    template <class resource>
+    inline resource_handle<resource> get_handle(const std::filesystem::path& rsc_path)
+    {
+        return this->get_or_create_resource_store_<resource>().get_handle(real_path_(rsc_path), *this);
+    }
+
     template <class resource>
     inline std::shared_ptr<resource> get_shared(const std::filesystem::path& rsc_path, std::nothrow_t)
     {
+        if (const mounted_pack* pack = find_pack_(rsc_path.native()))
+        {
+            load_error error;
+            return get_shared_from_pack_<resource>(*pack, rsc_path, &error);
+        }
         if (vlfs::virtual_filesystem::path_components path_comps = vlfs_->extract_components(rsc_path); path_comps)
         {
             return basic_resource_manager::get_shared<resource>(vlfs_->real_path(path_comps), std::nothrow);
@@ -48,11 +145,32 @@ public:
     template <class resource>
     inline std::shared_ptr<resource> get_shared(std::filesystem::path&& rsc_path, std::nothrow_t)
     {
+        if (find_pack_(rsc_path.native()))
+            return get_shared<resource>(static_cast<const std::filesystem::path&>(rsc_path), std::nothrow);
         std::filesystem::path real_path(std::move(rsc_path));
         vlfs_->convert_to_real_path(real_path);
         return basic_resource_manager::get_shared<resource>(real_path, std::nothrow);
     }
 
+#ifdef ARBA_RSCE_HAS_EXPECTED
+    template <class resource>
+    inline std::expected<std::shared_ptr<resource>, load_error> try_get_shared(const std::filesystem::path& rsc_path)
+    {
+        if (const mounted_pack* pack = find_pack_(rsc_path.native()))
+        {
+            load_error error;
+            if (std::shared_ptr<resource> rsc_sptr = get_shared_from_pack_<resource>(*pack, rsc_path, &error))
+                return rsc_sptr;
+            return std::unexpected(std::move(error));
+        }
+        if (vlfs::virtual_filesystem::path_components path_comps = vlfs_->extract_components(rsc_path); path_comps)
+        {
+            return basic_resource_manager::try_get_shared<resource>(vlfs_->real_path(path_comps));
+        }
+        return basic_resource_manager::try_get_shared<resource>(rsc_path);
+    }
+#endif
+
     template <class resource>
     inline resource& get(const std::filesystem::path& rsc_path)
     {
@@ -67,9 +185,97 @@ public:
         return *rsc_sptr;
     }
 
+    template <class resource, concepts::path_string string_type>
+    inline resource& get(const string_type& rsc_path)
+    {
+        std::shared_ptr<resource> rsc_sptr = get_shared<resource>(rsc_path);
+        return *rsc_sptr;
+    }
+
+    template <class resource>
+    inline resource& get(hashed_path_view rsc_path)
+    {
+        std::shared_ptr<resource> rsc_sptr = get_shared<resource>(rsc_path);
+        return *rsc_sptr;
+    }
+
+    template <class resource>
+    inline resource_future<resource> get_shared_async(const std::filesystem::path& rsc_path)
+    {
+        reject_pack_path_(rsc_path);
+        if (vlfs::virtual_filesystem::path_components path_comps = vlfs_->extract_components(rsc_path); path_comps)
+        {
+            return basic_resource_manager::get_shared_async<resource>(vlfs_->real_path(path_comps));
+        }
+        return this->get_or_create_resource_store_<resource>().get_shared_async(rsc_path, *this,
+                                                                                 this->counting_executor_);
+    }
+
+    template <class resource>
+    inline resource_future<resource> load_async(const std::filesystem::path& rsc_path,
+                                                load_mode mode = load_mode::force)
+    {
+        reject_pack_path_(rsc_path);
+        if (vlfs::virtual_filesystem::path_components path_comps = vlfs_->extract_components(rsc_path); path_comps)
+        {
+            return basic_resource_manager::load_async<resource>(vlfs_->real_path(path_comps), mode);
+        }
+        return basic_resource_manager::load_async<resource>(rsc_path, mode);
+    }
+
+    template <class resource>
+    inline void preload(std::span<const std::filesystem::path> rsc_paths)
+    {
+        preload_async<resource>(rsc_paths).wait();
+    }
+
+    template <class resource>
+    inline resource_preloading preload_async(std::span<const std::filesystem::path> rsc_paths)
+    {
+        std::vector<std::filesystem::path> real_rsc_paths;
+        real_rsc_paths.reserve(rsc_paths.size());
+        for (const std::filesystem::path& rsc_path : rsc_paths)
+            real_rsc_paths.push_back(real_path_(rsc_path));
+        return this->get_or_create_resource_store_<resource>().preload_async(real_rsc_paths, *this,
+                                                                              this->counting_executor_);
+    }
+
+    template <class resource, std::predicate<const std::filesystem::path&> predicate_type>
+    inline resource_preload_summary preload_directory(const std::filesystem::path& directory, bool recursive,
+                                                      predicate_type predicate)
+    {
+        return this->preload_directory_(real_path_(directory), recursive, std::move(predicate),
+                                        [this](std::span<const std::filesystem::path> rsc_paths) {
+                                            return preload_async<resource>(rsc_paths);
+                                        });
+    }
+
+    template <class resource>
+    inline resource_preload_summary preload_directory(const std::filesystem::path& directory, bool recursive,
+                                                      std::string_view extension)
+    {
+        return preload_directory<resource>(directory, recursive, this->extension_predicate_(extension));
+    }
+
+    template <class resource>
+    inline resource_preload_summary preload_directory(const std::filesystem::path& directory, bool recursive = true)
+    {
+        return preload_directory<resource>(directory, recursive, [](const std::filesystem::path&) { return true; });
+    }
+
+    // Resources are loaded with the basic_resource_manager interface.
+    inline void preload(std::span<const resource_preload_entry> entries)
+    {
+        // Checked before any loading starts.
+        for (const resource_preload_entry& entry : entries)
+            reject_pack_path_(entry.path());
+        this->preload_(entries, [this](const std::filesystem::path& rsc_path) { return real_path_(rsc_path); });
+    }
+
     template <class resource>
     inline bool insert(const std::filesystem::path& rsc_path, std::shared_ptr<resource> rsc_sptr)
     {
+        reject_pack_path_(rsc_path);
         if (vlfs::virtual_filesystem::path_components path_comps = vlfs_->extract_components(rsc_path); path_comps)
         {
             return this->basic_resource_manager::insert<resource>(vlfs_->real_path(path_comps), rsc_sptr);
@@ -80,6 +286,7 @@ public:
     template <class resource>
     inline bool insert(std::filesystem::path&& rsc_path, std::shared_ptr<resource> rsc_sptr)
     {
+        reject_pack_path_(rsc_path);
         std::filesystem::path real_path(std::move(rsc_path));
         vlfs_->convert_to_real_path(real_path);
         return this->basic_resource_manager::insert<resource>(real_path, rsc_sptr);
@@ -88,6 +295,7 @@ public:
     template <class resource>
     inline void set(const std::filesystem::path& rsc_path, std::shared_ptr<resource> rsc_sptr)
     {
+        reject_pack_path_(rsc_path);
         if (vlfs::virtual_filesystem::path_components path_comps = vlfs_->extract_components(rsc_path); path_comps)
         {
             this->basic_resource_manager::set<resource>(vlfs_->real_path(path_comps), std::move(rsc_sptr));
@@ -99,32 +307,37 @@ public:
     template <class resource>
     inline void set(std::filesystem::path&& rsc_path, std::shared_ptr<resource> rsc_sptr)
     {
+        reject_pack_path_(rsc_path);
         std::filesystem::path real_path(std::move(rsc_path));
         vlfs_->convert_to_real_path(real_path);
         this->basic_resource_manager::set<resource>(real_path, std::move(rsc_sptr));
     }
 
     template <class resource>
-    inline std::shared_ptr<resource> load(const std::filesystem::path& rsc_path)
+    inline std::shared_ptr<resource> load(const std::filesystem::path& rsc_path, load_mode mode = load_mode::force)
     {
+        reject_pack_path_(rsc_path);
         if (vlfs::virtual_filesystem::path_components path_comps = vlfs_->extract_components(rsc_path); path_comps)
         {
-            return basic_resource_manager::load<resource>(vlfs_->real_path(path_comps));
+            return basic_resource_manager::load<resource>(vlfs_->real_path(path_comps), mode);
         }
-        return basic_resource_manager::load<resource>(rsc_path);
+        return basic_resource_manager::load<resource>(rsc_path, mode);
     }
 
     template <class resource>
-    inline std::shared_ptr<resource> load(std::filesystem::path&& rsc_path)
+    inline std::shared_ptr<resource> load(std::filesystem::path&& rsc_path, load_mode mode = load_mode::force)
     {
+        reject_pack_path_(rsc_path);
         std::filesystem::path real_path(std::move(rsc_path));
         vlfs_->convert_to_real_path(real_path);
-        return basic_resource_manager::load<resource>(real_path);
+        return basic_resource_manager::load<resource>(real_path, mode);
     }
 
     template <class resource>
     inline std::shared_ptr<resource> load(const std::filesystem::path& rsc_path, std::nothrow_t)
     {
+        if (find_pack_(rsc_path.native())) [[unlikely]]
+            return std::shared_ptr<resource>();
         if (vlfs::virtual_filesystem::path_components path_comps = vlfs_->extract_components(rsc_path); path_comps)
         {
             return basic_resource_manager::load<resource>(vlfs_->real_path(path_comps), std::nothrow);
@@ -135,6 +348,8 @@ public:
     template <class resource>
     inline std::shared_ptr<resource> load(std::filesystem::path&& rsc_path, std::nothrow_t)
     {
+        if (find_pack_(rsc_path.native())) [[unlikely]]
+            return std::shared_ptr<resource>();
         std::filesystem::path real_path(std::move(rsc_path));
         vlfs_->convert_to_real_path(real_path);
         return basic_resource_manager::load<resource>(real_path, std::nothrow);
@@ -143,6 +358,7 @@ public:
     template <class resource>
     inline void remove(const std::filesystem::path& rsc_path)
     {
+        reject_pack_path_(rsc_path);
         if (vlfs::virtual_filesystem::path_components path_comps = vlfs_->extract_components(rsc_path); path_comps)
         {
             this->basic_resource_manager::remove<resource>(vlfs_->real_path(path_comps));
@@ -154,13 +370,106 @@ public:
     template <class resource>
     inline void remove(std::filesystem::path&& rsc_path)
     {
+        reject_pack_path_(rsc_path);
         std::filesystem::path real_path(std::move(rsc_path));
         vlfs_->convert_to_real_path(real_path);
         this->basic_resource_manager::remove<resource>(real_path);
     }
 
+private:
+    template <class resource, class key_type>
+    inline std::shared_ptr<resource> get_shared_spelling_(const key_type& rsc_path, path_string_view rsc_path_view)
+    {
+        resource_store<resource>& rsc_store = this->get_or_create_resource_store_<resource>();
+        if (std::shared_ptr<resource> rsc_sptr = rsc_store.find(rsc_path))
+            return rsc_sptr;
+        if (const mounted_pack* pack = find_pack_(rsc_path_view))
+            return get_shared_from_pack_<resource>(*pack, std::filesystem::path(rsc_path_view));
+        std::filesystem::path spelling(rsc_path_view);
+        if (vlfs::virtual_filesystem::path_components path_comps = vlfs_->extract_components(spelling); path_comps)
+        {
+            std::filesystem::path real_rsc_path = vlfs_->real_path(path_comps);
+            std::shared_ptr<resource> rsc_sptr = rsc_store.get_shared(real_rsc_path, *this);
+            rsc_store.cache_canonical_path(spelling, real_rsc_path);
+            return rsc_sptr;
+        }
+        return rsc_store.get_shared(spelling, *this);
+    }
+
+    struct mounted_pack
+    {
+        // The root name followed by ":/".
+        std::filesystem::path::string_type prefix;
+        std::shared_ptr<const resource_pack> pack;
+    };
+
+    inline const mounted_pack* find_pack_(path_string_view rsc_path) const
+    {
+        for (const mounted_pack& mounted : packs_)
+        {
+            if (rsc_path.starts_with(mounted.prefix))
+                return &mounted;
+        }
+        return nullptr;
+    }
+
+    // A failure is thrown if error is nullptr, otherwise it is stored in *error and nullptr is returned.
+    template <class resource>
+    inline std::shared_ptr<resource> get_shared_from_pack_(const mounted_pack& pack,
+                                                           const std::filesystem::path& rsc_path,
+                                                           load_error* error = nullptr)
+    {
+        if constexpr (!concepts::pack_loadable_resource<resource>
+                      && !concepts::pack_loadable_with_manager_resource<resource, resource_manager>)
+        {
+            // Only the resources loadable from memory or from a stream are loadable from a pack.
+            const std::error_code error_code = std::make_error_code(std::errc::operation_not_supported);
+            if (!error)
+                throw std::filesystem::filesystem_error("resource not loadable from a resource pack", rsc_path,
+                                                        error_code);
+            *error = load_error{ error_code, rsc_path };
+            return std::shared_ptr<resource>();
+        }
+        else
+        {
+            resource_store<resource>& rsc_store = this->get_or_create_resource_store_<resource>();
+            const path_string_view entry_path = path_string_view(rsc_path.native()).substr(pack.prefix.size());
+            auto get_shared = [&](std::string_view utf8_entry_path) {
+                if (error)
+                    return rsc_store.get_shared(rsc_path, *pack.pack, utf8_entry_path, *this, *error);
+                return rsc_store.get_shared(rsc_path, *pack.pack, utf8_entry_path, *this);
+            };
+            if constexpr (std::is_same_v<std::filesystem::path::value_type, char>)
+                return get_shared(entry_path);
+            else
+            {
+                // The entry paths of a pack are in UTF-8.
+                const std::u8string u8_entry_path = std::filesystem::path(entry_path).generic_u8string();
+                return get_shared(
+                    std::string_view(reinterpret_cast<const char*>(u8_entry_path.data()), u8_entry_path.size()));
+            }
+        }
+    }
+
+    inline void reject_pack_path_(const std::filesystem::path& rsc_path) const
+    {
+        if (find_pack_(rsc_path.native())) [[unlikely]]
+            throw std::filesystem::filesystem_error("operation not supported on a resource pack path", rsc_path,
+                                                    make_error_code(load_errc::pack_path_not_supported));
+    }
+
+    // Rejects the paths in a mounted pack.
+    inline std::filesystem::path real_path_(const std::filesystem::path& rsc_path) const
+    {
+        reject_pack_path_(rsc_path);
+        if (vlfs::virtual_filesystem::path_components path_comps = vlfs_->extract_components(rsc_path); path_comps)
+            return vlfs_->real_path(path_comps);
+        return rsc_path;
+    }
+
 private:
     vlfs::virtual_filesystem* vlfs_ = nullptr;
+    std::vector<mounted_pack> packs_;
 };
 
 } // namespace rsce
@@ -0,0 +1,126 @@
+#pragma once
+
+#include "mapped_file.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <map>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <variant>
+#include <vector>
+
+inline namespace arba
+{
+namespace rsce
+{
+
+// Single file holding the files of a directory tree (its entries), so that looking up a resource costs a binary search
+// in a memory mapping instead of opening, reading and closing a file (see resource_manager::mount_pack()). Packs are
+// written by resource_pack_builder, e.g. with the rsce-pack tool.
+//
+// Format, all integers little-endian:
+// - header, 32 bytes: the magic "RSCEPACK", the version (u32), the alignment of the blobs (u32), the number of entries
+//   (u64) and the size of the path table (u64).
+// - index, 32 bytes per entry, sorted by path (bytewise): the offset (u64) and the size (u64) of the blob of the
+//   entry, the offset in the path table (u32) and the size (u32) of the path of the entry, flags (u32, 0 for now) and
+//   a reserved u32 (0).
+// - path table: the paths of the entries, in UTF-8, relative to the root of the pack, with '/' separators.
+// - blobs, each at an offset multiple of the alignment of the blobs.
+class resource_pack
+{
+public:
+    static constexpr std::string_view magic = "RSCEPACK";
+    static constexpr std::uint32_t version = 1;
+    static constexpr std::size_t header_size = 32;
+    static constexpr std::size_t index_entry_size = 32;
+
+    // Maps the pack file and checks its index. Throws std::filesystem::filesystem_error if the file cannot be mapped
+    // or is not a valid pack.
+    explicit resource_pack(const std::filesystem::path& fpath);
+
+    inline const std::filesystem::path& path() const noexcept { return path_; }
+    inline std::size_t size() const noexcept { return number_of_entries_; }
+
+    // Returns the bytes of the entry entry_path (e.g. "ui/font.ttf"), which stay valid while the pack exists, or
+    // std::nullopt if the pack has no such entry. The filesystem is not accessed.
+    std::optional<std::span<const std::byte>> find(std::string_view entry_path) const noexcept;
+    // As find(), but throws std::filesystem::filesystem_error if the pack has no such entry.
+    std::span<const std::byte> at(std::string_view entry_path) const;
+
+    // Entries by index, in the order of their paths.
+    std::string_view entry_path(std::size_t index) const noexcept;
+    std::span<const std::byte> entry_bytes(std::size_t index) const noexcept;
+
+    // Returns true if entry_path is a valid entry path: not empty, relative, with '/' separators, and without empty,
+    // "." or ".." components.
+    static bool is_valid_entry_path(std::string_view entry_path) noexcept;
+
+private:
+    const std::byte* index_entry_(std::size_t index) const noexcept;
+
+    std::filesystem::path path_;
+    mapped_file file_;
+    std::size_t number_of_entries_ = 0;
+    const std::byte* paths_ = nullptr;
+};
+
+// Writes resource packs. The written file only depends on the added entries and on the options of the builder,
+// whatever the order the entries were added in and the number of threads.
+class resource_pack_builder
+{
+public:
+    struct write_summary
+    {
+        std::size_t number_of_entries = 0;
+        // Less than the number of entries if entries with identical contents share a blob (see deduplication()).
+        std::size_t number_of_blobs = 0;
+        std::uint64_t file_size = 0;
+    };
+
+    // blob_alignment must be a power of two.
+    explicit resource_pack_builder(std::size_t blob_alignment = 16);
+
+    // When true, the entries with identical contents share one blob. Contents are compared by hash, then byte by byte.
+    inline bool deduplication() const noexcept { return deduplication_; }
+    inline void set_deduplication(bool deduplication) noexcept { deduplication_ = deduplication; }
+    // Number of threads reading and hashing the files of the entries in write(), hardware concurrency by default.
+    inline std::size_t number_of_threads() const noexcept { return number_of_threads_; }
+    inline void set_number_of_threads(std::size_t number_of_threads) noexcept
+    {
+        number_of_threads_ = number_of_threads > 0 ? number_of_threads : 1;
+    }
+
+    // Adds the entry entry_path, replacing the entry of the same path if any. Throws std::invalid_argument if
+    // entry_path is not a valid entry path (see resource_pack::is_valid_entry_path()).
+    void add(std::string entry_path, std::vector<std::byte> bytes);
+    // As add(), but the contents of the entry are read from the file fpath by write().
+    void add_file(std::string entry_path, std::filesystem::path fpath);
+    // Adds the regular files of the directory tree dpath with add_file(). Their entry paths are their paths relative
+    // to dpath, after entry_prefix and '/' if entry_prefix is not empty. The pack excluded_pack_fpath and its temporary
+    // file (see write()) are skipped, so that a pack written in dpath does not contain itself. Returns the number of
+    // added files.
+    std::size_t add_directory(const std::filesystem::path& dpath, std::string_view entry_prefix = {},
+                              const std::filesystem::path& excluded_pack_fpath = {});
+
+    inline std::size_t size() const noexcept { return entries_.size(); }
+
+    // Writes the pack in the file fpath + ".tmp", then renames it fpath, so that fpath is never a partial pack. Throws
+    // std::filesystem::filesystem_error if a file of an entry cannot be read, or if the pack cannot be written.
+    write_summary write(const std::filesystem::path& fpath) const;
+
+private:
+    using entry_source = std::variant<std::vector<std::byte>, std::filesystem::path>;
+
+    std::size_t blob_alignment_;
+    bool deduplication_ = false;
+    std::size_t number_of_threads_;
+    std::map<std::string, entry_source, std::less<>> entries_;
+};
+
+} // namespace rsce
+} // namespace arba
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <exception>
+#include <filesystem>
+#include <functional>
+#include <new>
+#include <utility>
+#include <vector>
+
+inline namespace arba
+{
+namespace rsce
+{
+
+struct resource_load_failure
+{
+    std::filesystem::path path;
+    std::exception_ptr exception;
+};
+
+struct resource_preload_summary
+{
+    // Number of resources loaded or already stored.
+    std::size_t number_of_resources = 0;
+    // Total size of the files of these resources.
+    std::uintmax_t number_of_bytes = 0;
+    std::vector<resource_load_failure> failures;
+    std::chrono::steady_clock::duration duration{};
+};
+
+// Batch of loadings started by a preload_async() call. The loaded resources are inserted in their store, one batch
+// per shard, when the preloading is waited for (at the latest on destruction).
+class resource_preloading
+{
+public:
+    resource_preloading() = default;
+    explicit resource_preloading(std::function<std::vector<resource_load_failure>()> finish)
+        : finish_(std::move(finish))
+    {
+    }
+    resource_preloading(resource_preloading&& other) noexcept : finish_(std::exchange(other.finish_, nullptr)) {}
+    resource_preloading& operator=(resource_preloading&&) = delete;
+
+    ~resource_preloading()
+    {
+        try
+        {
+            wait(std::nothrow);
+        }
+        catch (...)
+        {
+        }
+    }
+
+    inline bool valid() const { return static_cast<bool>(finish_); }
+
+    // Runs the loadings not started yet on the calling thread, waits for the others, then inserts the loaded
+    // resources in their store. Once every loading has ended, the first loading error is rethrown.
+    inline void wait()
+    {
+        if (std::vector<resource_load_failure> failures = wait(std::nothrow); !failures.empty())
+            std::rethrow_exception(failures.front().exception);
+    }
+
+    // Same as wait(), but returns the failures instead of throwing.
+    inline std::vector<resource_load_failure> wait(std::nothrow_t)
+    {
+        if (finish_)
+            return std::exchange(finish_, nullptr)();
+        return std::vector<resource_load_failure>();
+    }
+
+    // Waits for each preloading, then rethrows the first loading error.
+    template <class preloading_range>
+    static void wait_all(preloading_range&& preloadings)
+    {
+        std::exception_ptr exception;
+        for (resource_preloading& preloading : preloadings)
+        {
+            try
+            {
+                preloading.wait();
+            }
+            catch (...)
+            {
+                if (!exception)
+                    exception = std::current_exception();
+            }
+        }
+        if (exception)
+            std::rethrow_exception(exception);
+    }
+
+private:
+    std::function<std::vector<resource_load_failure>()> finish_;
+};
+
+} // namespace rsce
+} // namespace arba
@@ -1,15 +1,44 @@
 #pragma once
 
+#include "atomic_snapshot.hpp"
+#include "flat_hash_map.hpp"
+#include "hashed_path.hpp"
+#include "load_error.hpp"
 #include "load_resource_from_file.hpp"
+#include "load_resource_from_pack.hpp"
+#include "loader_executor.hpp"
+#include "path_normalizer.hpp"
+#include "resource_future.hpp"
+#include "resource_handle.hpp"
+#include "resource_id.hpp"
+#include "resource_preloading.hpp"
+#include "segmented_array.hpp"
 
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <cassert>
+#include <chrono>
 #include <concepts>
+#include <cstdint>
+#include <exception>
 #include <filesystem>
 #include <format>
 #include <functional>
+#include <future>
+#include <limits>
 #include <memory>
 #include <mutex>
+#include <shared_mutex>
+#include <span>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
 #include <unordered_map>
+#include <vector>
+#ifdef ARBA_RSCE_HAS_EXPECTED
+#include <expected>
+#endif
 
 inline namespace arba
 {
@@ -18,192 +47,1758 @@ namespace rsce
 
 class basic_resource_manager;
 
+namespace concepts
+{
+// String type usable for heterogeneous lookups in a resource store, without constructing a path.
+template <class string_type>
+concept path_string = std::convertible_to<const string_type&, path_string_view>;
+} // namespace concepts
+
 class resource_store_base
 {
 public:
     virtual ~resource_store_base() = default;
 
+    // Forgets the canonical paths computed so far, to be called when files or links were moved.
+    virtual void invalidate_canonical_paths() {}
+    // Forgets the failures remembered so far (see negative_cache_ttl), to be called when files were added or fixed.
+    virtual void forget_failures() {}
+
 protected:
     inline resource_store_base() = default;
 
+    // Returns a new identifier, never 0, unique among the stores of the process.
+    static std::uint64_t generate_store_id_() noexcept;
+
+    // Hash and equality of the native strings of paths, for heterogeneous lookups by path_string_view. The hash is
+    // hash_path_string(), so that the precomputed hash of a hashed_path_view is used as is.
     struct filesystem_path_hash
     {
+        using is_transparent = void;
+
         std::size_t operator()(const std::filesystem::path& arg) const noexcept;
+        std::size_t operator()(path_string_view arg) const noexcept;
+        inline std::size_t operator()(hashed_path_view arg) const noexcept { return arg.hash(); }
+    };
+
+    struct filesystem_path_equal
+    {
+        using is_transparent = void;
+
+        inline bool operator()(path_string_view left, path_string_view right) const noexcept { return left == right; }
+        inline bool operator()(const std::filesystem::path& left, path_string_view right) const noexcept
+        {
+            return left.native() == right;
+        }
+        inline bool operator()(path_string_view left, const std::filesystem::path& right) const noexcept
+        {
+            return left == right.native();
+        }
+        inline bool operator()(const std::filesystem::path& left, const std::filesystem::path& right) const noexcept
+        {
+            return left.native() == right.native();
+        }
+        inline bool operator()(const std::filesystem::path& left, hashed_path_view right) const noexcept
+        {
+            return left.native() == right.native();
+        }
+        inline bool operator()(hashed_path_view left, const std::filesystem::path& right) const noexcept
+        {
+            return left.native() == right.native();
+        }
     };
 };
 
-template <class resource_type>
+// Behavior of default_resource_store::load() when the resource is being loaded by another call.
+enum class load_mode
+{
+    // Returns the resource of the loading in progress. Otherwise, loads the resource.
+    join,
+    // Waits for the loading in progress, then loads the resource again.
+    force
+};
+
+struct default_resource_store_policy
+{
+    // When true, cached resources are looked up in an immutable snapshot of the dictionary (see atomic_snapshot),
+    // published by writers: cache hits take no lock, while insert(), set(), remove() and loads copy the dictionary.
+    static constexpr bool read_mostly = false;
+
+    // Number of hash-partitioned shards of the dictionary. Each shard has its own lock, so lookups of paths stored
+    // in different shards never contend.
+    static constexpr std::size_t number_of_shards = 1;
+
+    // Computes the canonical path used as key of a resource (see path_normalizer.hpp).
+    using path_normalizer = canonical_path_normalizer;
+
+    // When true and path_normalizer accesses the filesystem, the canonical path of each path spelling ever looked up
+    // is cached, so that a lookup with a non-canonical spelling (relative path, "..", links) costs a hash probe
+    // instead of filesystem accesses. As relative spellings are resolved from the current directory,
+    // invalidate_canonical_paths() must be called when it changes.
+    static constexpr bool cache_canonical_paths = true;
+
+    // Number of entries of a cache of resources of each thread, in front of get_shared() with a path. The cache is
+    // two-way set-associative, so that two hot paths mapped to the same set do not evict each other. A cache hit
+    // takes no lock and reads no shared data but an epoch counter of the store, which set(), remove(), clear() and
+    // invalidate_canonical_paths() increment to invalidate the caches. A cached resource stays alive until its entry
+    // is replaced or its thread exits. 0 disables the cache.
+    static constexpr std::size_t thread_cache_size = 0;
+
+    // Duration during which a failure of get_shared(), get_shared_async() or preload_async() is remembered, whether
+    // the canonical path could not be made (e.g. the file does not exist) or the loading threw: get_shared() with the
+    // same path then throws the same exception, and get_shared() with std::nothrow returns nullptr, without accessing
+    // the filesystem. A failure is forgotten when the resource is loaded or stored with its canonical path, and by
+    // forget_failures(), clear() and invalidate_canonical_paths(). std::chrono::milliseconds::max() remembers failures
+    // until then, 0 disables the negative cache.
+    static constexpr std::chrono::milliseconds negative_cache_ttl = std::chrono::milliseconds::zero();
+
+    // Map type of the dictionaries looked up by path: the resources and the cached canonical paths.
+    template <class key_type, class mapped_type, class hash_type, class key_equal_type>
+    using dictionary = std::unordered_map<key_type, mapped_type, hash_type, key_equal_type>;
+};
+
+struct read_mostly_resource_store_policy : public default_resource_store_policy
+{
+    static constexpr bool read_mostly = true;
+};
+
+// For read-only resource directories without links.
+struct lexical_resource_store_policy : public default_resource_store_policy
+{
+    using path_normalizer = lexical_path_normalizer<>;
+};
+
+// Lookups probe a flat table instead of following the node chains of a bucket.
+struct flat_resource_store_policy : public default_resource_store_policy
+{
+    template <class key_type, class mapped_type, class hash_type, class key_equal_type>
+    using dictionary = flat_hash_map<key_type, mapped_type, hash_type, key_equal_type>;
+};
+
+// For threads looking up the same few resources again and again.
+template <std::size_t thread_cache_size_value = 256>
+struct thread_cached_resource_store_policy : public default_resource_store_policy
+{
+    static_assert(thread_cache_size_value % 2 == 0);
+
+    static constexpr std::size_t thread_cache_size = thread_cache_size_value;
+};
+
+// For probes of optional resources, which may not exist.
+template <std::chrono::milliseconds::rep negative_cache_ttl_value = std::chrono::milliseconds::max().count()>
+struct negative_cached_resource_store_policy : public default_resource_store_policy
+{
+    static_assert(negative_cache_ttl_value > 0);
+
+    static constexpr std::chrono::milliseconds negative_cache_ttl = std::chrono::milliseconds(negative_cache_ttl_value);
+};
+
+template <std::size_t number_of_shards_value>
+struct sharded_resource_store_policy : public default_resource_store_policy
+{
+    static constexpr std::size_t number_of_shards = number_of_shards_value;
+};
+
+template <class resource_type, class policy_type = default_resource_store_policy>
 class default_resource_store : public resource_store_base
 {
+    static_assert(policy_type::number_of_shards > 0);
+
 public:
     using resource = resource_type;
     using resource_sptr = std::shared_ptr<resource>;
+    using policy = policy_type;
 
 private:
-    using resource_dico = std::unordered_map<std::filesystem::path, resource_sptr, filesystem_path_hash>;
+    template <class mapped_type>
+    using path_dictionary = typename policy_type::template dictionary<std::filesystem::path, mapped_type,
+                                                                      filesystem_path_hash, filesystem_path_equal>;
+    using resource_dico = path_dictionary<resource_sptr>;
+    // Canonical paths are shared, so that a lookup by path_string_view copies no path, and are stored with their hash.
+    using canonical_path_dico = path_dictionary<std::shared_ptr<const hashed_path>>;
+
+    struct loading_resource
+    {
+        std::shared_future<resource_sptr> future;
+        // Queued loading task, or nullptr if the resource is loaded synchronously by the calling thread.
+        std::shared_ptr<resource_loading_task> task;
+        // True once another lookup waits for the future: a failure must then be stored in it as an exception.
+        bool joined = false;
+    };
+    using loading_resource_dico =
+        std::unordered_map<std::filesystem::path, loading_resource, filesystem_path_hash, filesystem_path_equal>;
+    using resource_id_dico =
+        std::unordered_map<std::filesystem::path, std::uint32_t, filesystem_path_hash, filesystem_path_equal>;
+
+    struct failure
+    {
+        // nullptr if no failure is remembered.
+        std::exception_ptr exception;
+        std::error_code code;
+        std::chrono::steady_clock::time_point expiry;
+    };
+    using failure_dico = path_dictionary<failure>;
 
 public:
     default_resource_store() = default;
     virtual ~default_resource_store() override = default;
 
-    inline std::size_t size() { return resources_.size(); }
-    inline void clear() { resources_.clear(); }
-    inline void reserve(std::size_t capacity) { resources_.reserve(capacity); }
+    inline std::size_t size();
+    inline void clear();
+    inline void reserve(std::size_t capacity);
 
     template <class resource_manager_type>
     resource_sptr get_shared(const std::filesystem::path& rsc_path, resource_manager_type& rsc_manager);
     resource_sptr get_shared(const std::filesystem::path& rsc_path);
+    // A cache hit (see find()) constructs no path.
+    template <concepts::path_string string_type, class resource_manager_type>
+    resource_sptr get_shared(const string_type& rsc_path, resource_manager_type& rsc_manager);
+    template <concepts::path_string string_type>
+    resource_sptr get_shared(const string_type& rsc_path);
+    // As above, without hashing rsc_path on a cache hit (see find()).
+    template <class resource_manager_type>
+    resource_sptr get_shared(hashed_path_view rsc_path, resource_manager_type& rsc_manager);
+    resource_sptr get_shared(hashed_path_view rsc_path);
+    // Returns nullptr instead of throwing. A failure costs no exception, unless the resource loader throws (see
+    // load_resource_from_file(path, error_code)), the failure is remembered (see negative_cache_ttl), or the failed
+    // loading of another thread is joined.
+    template <class resource_manager_type>
+    resource_sptr get_shared(const std::filesystem::path& rsc_path, resource_manager_type& rsc_manager,
+                             std::nothrow_t);
+    resource_sptr get_shared(const std::filesystem::path& rsc_path, std::nothrow_t);
+#ifdef ARBA_RSCE_HAS_EXPECTED
+    // As get_shared(), but a failure is returned instead of thrown, and costs an exception as with std::nothrow.
+    template <class resource_manager_type>
+    std::expected<resource_sptr, load_error> try_get_shared(const std::filesystem::path& rsc_path,
+                                                            resource_manager_type& rsc_manager);
+    std::expected<resource_sptr, load_error> try_get_shared(const std::filesystem::path& rsc_path);
+#endif
+
+    // Returns the resource stored with rsc_key, or loads it from the entry entry_path of rsc_pack (see
+    // load_resource_from_pack()) and stores it with rsc_key. rsc_key is not normalized, and the filesystem is not
+    // accessed (e.g. "PACK:/ui/font.ttf", see resource_manager::mount_pack()).
+    template <class resource_manager_type>
+    resource_sptr get_shared(const std::filesystem::path& rsc_key, const resource_pack& rsc_pack,
+                             std::string_view entry_path, resource_manager_type& rsc_manager);
+    resource_sptr get_shared(const std::filesystem::path& rsc_key, const resource_pack& rsc_pack,
+                             std::string_view entry_path)
+        requires concepts::pack_loadable_resource<resource_type>;
+    // As above, but the failure is stored in error and nullptr is returned instead of thrown (see get_shared() with
+    // std::nothrow).
+    template <class resource_manager_type>
+    resource_sptr get_shared(const std::filesystem::path& rsc_key, const resource_pack& rsc_pack,
+                             std::string_view entry_path, resource_manager_type& rsc_manager, load_error& error);
+
+    // Returns the identifier of the canonical path of rsc_path, the same for each call. The resource is not loaded.
+    resource_id<resource_type> intern(const std::filesystem::path& rsc_path);
+    // The resource of an interned path is looked up by array index, without hashing. It is loaded if it is not
+    // stored. Throws std::out_of_range if the index of rsc_id is out of range. An identifier returned by intern() of
+    // another store is not detected: it designates the path interned with the same index in this store, if any.
+    template <class resource_manager_type>
+    resource_sptr get_shared(resource_id<resource_type> rsc_id, resource_manager_type& rsc_manager);
+    resource_sptr get_shared(resource_id<resource_type> rsc_id);
 
+    // Interns rsc_path, loads its resource if it is not stored, and returns a handle on it.
     template <class resource_manager_type>
-    inline resource_sptr load(const std::filesystem::path& rsc_path, resource_manager_type& rsc_manager);
-    inline resource_sptr load(const std::filesystem::path& rsc_path);
+    resource_handle<resource_type> get_handle(const std::filesystem::path& rsc_path,
+                                              resource_manager_type& rsc_manager);
+    resource_handle<resource_type> get_handle(const std::filesystem::path& rsc_path);
+    template <class resource_manager_type>
+    resource_handle<resource_type> get_handle(resource_id<resource_type> rsc_id, resource_manager_type& rsc_manager);
+    resource_handle<resource_type> get_handle(resource_id<resource_type> rsc_id);
+
+    // Loads the resource, and stores it if no resource is stored with its canonical path. At most one loading of a
+    // canonical path is in progress at a time, whatever the function which started it (get_shared(), load(),
+    // preload_async(), ...): mode tells whether to join it or to load again after it.
+    template <class resource_manager_type>
+    inline resource_sptr load(const std::filesystem::path& rsc_path, resource_manager_type& rsc_manager,
+                              load_mode mode = load_mode::force);
+    inline resource_sptr load(const std::filesystem::path& rsc_path, load_mode mode = load_mode::force);
+    // As load() with load_mode::force, but returns nullptr instead of throwing (see get_shared() with std::nothrow).
+    template <class resource_manager_type>
+    inline resource_sptr load(const std::filesystem::path& rsc_path, resource_manager_type& rsc_manager,
+                              std::nothrow_t);
+    inline resource_sptr load(const std::filesystem::path& rsc_path, std::nothrow_t);
+
+    // The asynchronous loading is submitted to executor, which must run it before the store is destroyed.
+    // Concurrent requests of the same resource share the same loading.
+    template <class resource_manager_type, concepts::executor executor_type>
+    resource_future<resource_type> get_shared_async(const std::filesystem::path& rsc_path,
+                                                    resource_manager_type& rsc_manager, executor_type& executor);
+    template <concepts::executor executor_type>
+    resource_future<resource_type> get_shared_async(const std::filesystem::path& rsc_path, executor_type& executor);
+
+    template <class resource_manager_type, concepts::executor executor_type>
+    resource_future<resource_type> load_async(const std::filesystem::path& rsc_path,
+                                              resource_manager_type& rsc_manager, executor_type& executor,
+                                              load_mode mode = load_mode::force);
+    template <concepts::executor executor_type>
+    resource_future<resource_type> load_async(const std::filesystem::path& rsc_path, executor_type& executor,
+                                              load_mode mode = load_mode::force);
+
+    // Loads in parallel on executor the resources which are neither stored nor being loaded. Paths are canonicalized
+    // and deduplicated, and the loaded resources are inserted when the returned preloading is waited for, which must
+    // happen before the store is destroyed.
+    template <class resource_manager_type, concepts::executor executor_type>
+    resource_preloading preload_async(std::span<const std::filesystem::path> rsc_paths,
+                                      resource_manager_type& rsc_manager, executor_type& executor);
+    template <concepts::executor executor_type>
+    resource_preloading preload_async(std::span<const std::filesystem::path> rsc_paths, executor_type& executor);
+
+    // Returns the resource stored with rsc_path or its cached canonical path as key, or nullptr. The resource is never
+    // loaded, and neither the filesystem nor the path is accessed.
+    resource_sptr find(path_string_view rsc_path);
+    resource_sptr find(hashed_path_view rsc_path);
+    // Caches the canonical path of real_rsc_path as the one of the spelling rsc_path (e.g. a virtual path), so that
+    // find(rsc_path) finds its resource. Does nothing if canonical paths are not cached (see cache_canonical_paths).
+    void cache_canonical_path(const std::filesystem::path& rsc_path, const std::filesystem::path& real_rsc_path);
 
     inline bool insert(const std::filesystem::path& rsc_path, resource_sptr rsc_sptr);
     inline void set(const std::filesystem::path& rsc_path, resource_sptr rsc_sptr);
     inline void remove(const std::filesystem::path& rsc_path);
 
+    virtual void invalidate_canonical_paths() override;
+    virtual void forget_failures() override;
+
 private:
-    inline resource_sptr load_canonical_(const std::filesystem::path& rsc_path);
+    struct resource_shard;
+
+    template <class resource_manager_type>
+    inline static auto file_loader_(resource_manager_type& rsc_manager);
+    inline static auto file_loader_();
+    // The nothrow loaders store their failure in an error code instead of throwing it (see
+    // load_resource_from_file(path, error_code)).
     template <class resource_manager_type>
-        requires traits::is_loadable_resource_v<resource_type, resource_manager_type>
-    inline resource_sptr load_canonical_(const std::filesystem::path& rsc_path, resource_manager_type& rsc_manager);
-    resource_sptr emplace_if_valid_(const std::filesystem::path& rsc_path, resource_sptr rsc_sptr);
+    inline static auto nothrow_file_loader_(resource_manager_type& rsc_manager);
+    inline static auto nothrow_file_loader_();
+    template <class loader_type>
+    static constexpr bool is_nothrow_loader_v =
+        std::is_invocable_v<loader_type&, const std::filesystem::path&, std::error_code&>;
+    template <class key_type>
+    inline resource_sptr find_(const key_type& rsc_path);
+    template <class key_type>
+    resource_sptr find_spelling_(const key_type& rsc_path);
+    std::filesystem::path canonical_(const std::filesystem::path& rsc_path);
+    std::filesystem::path canonical_(const std::filesystem::path& rsc_path, std::error_code& error_code);
+    // A failure is thrown, unless loader is a nothrow loader: the failure is then stored in *error and nullptr is
+    // returned, and no exception is thrown (see report_failure_()).
+    template <class loader_type>
+    resource_sptr get_shared_(const std::filesystem::path& rsc_path, loader_type&& loader,
+                              load_error* error = nullptr);
+    // Returns the resource stored with c_rsc_path, or joins its loading in progress, or else loads it. Failures are
+    // reported as by get_shared_().
+    template <class loader_type>
+    resource_sptr get_or_load_(const std::filesystem::path& c_rsc_path, loader_type&& loader,
+                               load_error* error = nullptr);
+    template <class loader_type, class executor_type>
+    resource_future<resource_type> get_shared_async_(const std::filesystem::path& rsc_path, loader_type&& loader,
+                                                     executor_type& executor);
+    template <class loader_type>
+    resource_sptr load_(const std::filesystem::path& rsc_path, load_mode mode, loader_type&& loader,
+                        load_error* error = nullptr);
+    // Returns the loaded resource, or the stored one if return_stored_resource is true and another resource was
+    // stored meanwhile. rsc_promise is fulfilled with the returned resource.
+    template <class loader_type>
+    resource_sptr load_and_publish_(resource_shard& shard, const std::filesystem::path& c_rsc_path,
+                                    std::promise<resource_sptr>& rsc_promise, loader_type& loader,
+                                    bool return_stored_resource = true);
+    // As above with a nothrow loader: the failure is stored in error, and nullptr is returned. The failure only costs
+    // an exception if it is remembered (see negative_cache_ttl) or if the loading is joined.
+    template <class loader_type>
+    resource_sptr load_and_publish_(resource_shard& shard, const std::filesystem::path& c_rsc_path,
+                                    std::promise<resource_sptr>& rsc_promise, loader_type& loader, load_error& error,
+                                    bool return_stored_resource = true);
+    // Stores the loaded resource if no resource is stored with c_rsc_path, and ends its loading. Returns the loaded
+    // resource, or the stored one if return_stored_resource is true.
+    resource_sptr publish_(resource_shard& shard, const std::filesystem::path& c_rsc_path, resource_sptr rsc_sptr,
+                           bool return_stored_resource);
+    template <class load_function_type, class executor_type>
+    resource_future<resource_type> submit_load_(load_function_type&& load_function, executor_type& executor);
+    template <class loader_type, class executor_type>
+    resource_preloading preload_async_(std::span<const std::filesystem::path> rsc_paths, loader_type&& loader,
+                                       executor_type& executor);
+    template <class loader_type>
+    resource_sptr get_shared_(resource_id<resource_type> rsc_id, loader_type&& loader);
+    template <class loader_type>
+    resource_handle<resource_type> get_handle_(resource_id<resource_type> rsc_id, loader_type&& loader);
+    [[noreturn]] void throw_resource_not_loaded_(const std::filesystem::path& c_rsc_path);
+    // Returns the exception thrown by get_shared() for error.
+    static std::exception_ptr make_exception_(const load_error& error);
+    // Rethrows exception if error is nullptr. Otherwise, stores the failure in *error and returns nullptr.
+    static resource_sptr report_failure_(load_error* error, std::error_code code, const std::filesystem::path& rsc_path,
+                                         std::exception_ptr exception);
+
+    // Returns the failure remembered with rsc_path as key, if any (see negative_cache_ttl).
+    failure find_failure_(const std::filesystem::path& rsc_path);
+    // Must be called with the mutex of shard locked. code is computed from exception if it is not given.
+    inline void remember_failure_(resource_shard& shard, const std::filesystem::path& rsc_path,
+                                  std::exception_ptr exception, std::error_code code = std::error_code());
+    inline void forget_failure_(resource_shard& shard, const std::filesystem::path& rsc_path);
+
+    struct thread_cache_entry
+    {
+        // 0 if the entry is empty.
+        std::uint64_t store_id = 0;
+        std::uint64_t epoch = 0;
+        std::size_t hash = 0;
+        std::filesystem::path rsc_path;
+        resource_sptr rsc_sptr;
+    };
+
+    // Looks rsc_path up in the cache of the calling thread, or calls lookup_function and caches its result.
+    template <class key_type, class lookup_function_type>
+    inline resource_sptr get_shared_cached_(const key_type& rsc_path, lookup_function_type&& lookup_function);
+    // Must be called after each replacement or removal of a resource.
+    inline void invalidate_thread_caches_();
 
 private:
-    resource_dico resources_;
-    std::recursive_mutex mutex_;
+    struct alignas(64) resource_shard
+    {
+        resource_dico resources;
+        loading_resource_dico loading_resources;
+        // Canonical paths of the path spellings of this shard (see cache_canonical_paths).
+        canonical_path_dico canonical_paths;
+        // Slot indexes of the interned paths of this shard.
+        resource_id_dico resource_ids;
+        // Failures of the path spellings which have no canonical path, and of the canonical paths which were not
+        // loaded (see negative_cache_ttl).
+        failure_dico failures;
+        atomic_snapshot<resource_dico> resources_snapshot;
+        std::shared_mutex mutex;
+
+        inline resource_shard() { publish_resources(); }
+
+        // Must be called with mutex locked, after each modification of resources.
+        inline void publish_resources()
+        {
+            if constexpr (policy_type::read_mostly)
+                resources_snapshot.store(std::make_unique<const resource_dico>(resources));
+        }
+    };
+
+    template <class key_type>
+    inline resource_shard& shard_(const key_type& rsc_path);
+
+    using resource_slot = rsce::resource_slot<resource_type>;
+
+    inline resource_slot& slot_(resource_id<resource_type> rsc_id);
+    // Must be called with the mutex of shard locked, after each modification of the resource stored with rsc_path.
+    inline void update_slot_(resource_shard& shard, const std::filesystem::path& rsc_path,
+                             const resource_sptr& rsc_sptr);
+
+private:
+    std::array<resource_shard, policy_type::number_of_shards> shards_;
+    segmented_array<resource_slot> slots_;
+    // Serializes the appends to slots_. Locked after a shard mutex.
+    std::mutex slots_mutex_;
+    // Identify the entries of the thread caches which are valid for this store (see thread_cache_size).
+    const std::uint64_t store_id_ = generate_store_id_();
+    std::atomic_uint64_t epoch_ = 0;
 };
 
 // Template methods implementation:
 
-template <class resource_type>
+template <class resource_type, class policy_type>
+std::size_t default_resource_store<resource_type, policy_type>::size()
+{
+    std::size_t number_of_resources = 0;
+    for (resource_shard& shard : shards_)
+    {
+        std::shared_lock lock(shard.mutex);
+        number_of_resources += shard.resources.size();
+    }
+    return number_of_resources;
+}
+
+template <class resource_type, class policy_type>
+void default_resource_store<resource_type, policy_type>::clear()
+{
+    for (resource_shard& shard : shards_)
+    {
+        std::lock_guard lock(shard.mutex);
+        shard.resources.clear();
+        shard.failures.clear();
+        shard.publish_resources();
+        for (const auto& [rsc_path, slot_index] : shard.resource_ids)
+        {
+            resource_slot& slot = slots_[slot_index];
+            resource_sptr old_rsc_sptr;
+            std::lock_guard slot_lock(slot.mutex);
+            old_rsc_sptr = slot.assign(nullptr);
+        }
+    }
+    invalidate_thread_caches_();
+}
+
+template <class resource_type, class policy_type>
+void default_resource_store<resource_type, policy_type>::reserve(std::size_t capacity)
+{
+    const std::size_t shard_capacity = (capacity + shards_.size() - 1) / shards_.size();
+    for (resource_shard& shard : shards_)
+    {
+        std::lock_guard lock(shard.mutex);
+        shard.resources.reserve(shard_capacity);
+    }
+}
+
+template <class resource_type, class policy_type>
 template <class resource_manager_type>
-default_resource_store<resource_type>::resource_sptr
-default_resource_store<resource_type>::get_shared(const std::filesystem::path& rsc_path,
-                                                  resource_manager_type& rsc_manager)
+default_resource_store<resource_type, policy_type>::resource_sptr
+default_resource_store<resource_type, policy_type>::get_shared(const std::filesystem::path& rsc_path,
+                                                               resource_manager_type& rsc_manager)
 {
-    std::lock_guard lock(mutex_);
+    return get_shared_cached_(rsc_path, [&]() { return get_shared_(rsc_path, file_loader_(rsc_manager)); });
+}
 
-    auto iter = resources_.find(rsc_path);
-    if (iter != resources_.end())
-        return iter->second;
+template <class resource_type, class policy_type>
+default_resource_store<resource_type, policy_type>::resource_sptr
+default_resource_store<resource_type, policy_type>::get_shared(const std::filesystem::path& rsc_path)
+{
+    return get_shared_cached_(rsc_path, [&]() { return get_shared_(rsc_path, file_loader_()); });
+}
 
-    std::filesystem::path c_rsc_path = std::filesystem::canonical(rsc_path);
-    iter = resources_.find(c_rsc_path);
-    if (iter != resources_.end())
-        return iter->second;
+template <class resource_type, class policy_type>
+template <class resource_manager_type>
+default_resource_store<resource_type, policy_type>::resource_sptr
+default_resource_store<resource_type, policy_type>::get_shared(const std::filesystem::path& rsc_path,
+                                                               resource_manager_type& rsc_manager, std::nothrow_t)
+{
+    load_error error;
+    return get_shared_cached_(rsc_path,
+                              [&]() { return get_shared_(rsc_path, nothrow_file_loader_(rsc_manager), &error); });
+}
+
+template <class resource_type, class policy_type>
+default_resource_store<resource_type, policy_type>::resource_sptr
+default_resource_store<resource_type, policy_type>::get_shared(const std::filesystem::path& rsc_path, std::nothrow_t)
+{
+    load_error error;
+    return get_shared_cached_(rsc_path, [&]() { return get_shared_(rsc_path, nothrow_file_loader_(), &error); });
+}
+
+#ifdef ARBA_RSCE_HAS_EXPECTED
+
+template <class resource_type, class policy_type>
+template <class resource_manager_type>
+std::expected<typename default_resource_store<resource_type, policy_type>::resource_sptr, load_error>
+default_resource_store<resource_type, policy_type>::try_get_shared(const std::filesystem::path& rsc_path,
+                                                                   resource_manager_type& rsc_manager)
+{
+    load_error error;
+    if (resource_sptr rsc_sptr = get_shared_cached_(
+            rsc_path, [&]() { return get_shared_(rsc_path, nothrow_file_loader_(rsc_manager), &error); }))
+        [[likely]]
+        return rsc_sptr;
+    return std::unexpected(std::move(error));
+}
+
+template <class resource_type, class policy_type>
+std::expected<typename default_resource_store<resource_type, policy_type>::resource_sptr, load_error>
+default_resource_store<resource_type, policy_type>::try_get_shared(const std::filesystem::path& rsc_path)
+{
+    load_error error;
+    if (resource_sptr rsc_sptr =
+            get_shared_cached_(rsc_path, [&]() { return get_shared_(rsc_path, nothrow_file_loader_(), &error); }))
+        [[likely]]
+        return rsc_sptr;
+    return std::unexpected(std::move(error));
+}
+
+#endif
+
+template <class resource_type, class policy_type>
+template <class resource_manager_type>
+default_resource_store<resource_type, policy_type>::resource_sptr
+default_resource_store<resource_type, policy_type>::get_shared(const std::filesystem::path& rsc_key,
+                                                               const resource_pack& rsc_pack,
+                                                               std::string_view entry_path,
+                                                               resource_manager_type& rsc_manager)
+{
+    return get_shared_cached_(rsc_key, [&]() {
+        if (resource_sptr rsc_sptr = find_(rsc_key))
+            return rsc_sptr;
+        if (failure rsc_failure = find_failure_(rsc_key); rsc_failure.exception) [[unlikely]]
+            std::rethrow_exception(std::move(rsc_failure.exception));
+        return get_or_load_(rsc_key, [&](const std::filesystem::path&) {
+            return load_resource_from_pack<resource_type>(rsc_pack, entry_path, rsc_manager);
+        });
+    });
+}
+
+template <class resource_type, class policy_type>
+default_resource_store<resource_type, policy_type>::resource_sptr
+default_resource_store<resource_type, policy_type>::get_shared(const std::filesystem::path& rsc_key,
+                                                               const resource_pack& rsc_pack,
+                                                               std::string_view entry_path)
+    requires concepts::pack_loadable_resource<resource_type>
+{
+    return get_shared_cached_(rsc_key, [&]() {
+        if (resource_sptr rsc_sptr = find_(rsc_key))
+            return rsc_sptr;
+        if (failure rsc_failure = find_failure_(rsc_key); rsc_failure.exception) [[unlikely]]
+            std::rethrow_exception(std::move(rsc_failure.exception));
+        return get_or_load_(rsc_key, [&](const std::filesystem::path&) {
+            return load_resource_from_pack<resource_type>(rsc_pack, entry_path);
+        });
+    });
+}
+
+template <class resource_type, class policy_type>
+template <class resource_manager_type>
+default_resource_store<resource_type, policy_type>::resource_sptr
+default_resource_store<resource_type, policy_type>::get_shared(const std::filesystem::path& rsc_key,
+                                                               const resource_pack& rsc_pack,
+                                                               std::string_view entry_path,
+                                                               resource_manager_type& rsc_manager, load_error& error)
+{
+    return get_shared_cached_(rsc_key, [&]() {
+        if (resource_sptr rsc_sptr = find_(rsc_key))
+            return rsc_sptr;
+        if (failure rsc_failure = find_failure_(rsc_key); rsc_failure.exception) [[unlikely]]
+            return report_failure_(&error, rsc_failure.code, rsc_key, nullptr);
+        return get_or_load_(
+            rsc_key,
+            [&](const std::filesystem::path&, std::error_code& error_code) {
+                return load_resource_from_pack<resource_type>(rsc_pack, entry_path, rsc_manager, error_code);
+            },
+            &error);
+    });
+}
+
+template <class resource_type, class policy_type>
+template <concepts::path_string string_type, class resource_manager_type>
+default_resource_store<resource_type, policy_type>::resource_sptr
+default_resource_store<resource_type, policy_type>::get_shared(const string_type& rsc_path,
+                                                               resource_manager_type& rsc_manager)
+{
+    const path_string_view rsc_path_view = rsc_path;
+    return get_shared_cached_(rsc_path_view, [&]() {
+        if (resource_sptr rsc_sptr = find(rsc_path_view))
+            return rsc_sptr;
+        return get_shared_(std::filesystem::path(rsc_path_view), file_loader_(rsc_manager));
+    });
+}
+
+template <class resource_type, class policy_type>
+template <concepts::path_string string_type>
+default_resource_store<resource_type, policy_type>::resource_sptr
+default_resource_store<resource_type, policy_type>::get_shared(const string_type& rsc_path)
+{
+    const path_string_view rsc_path_view = rsc_path;
+    return get_shared_cached_(rsc_path_view, [&]() {
+        if (resource_sptr rsc_sptr = find(rsc_path_view))
+            return rsc_sptr;
+        return get_shared_(std::filesystem::path(rsc_path_view), file_loader_());
+    });
+}
+
+template <class resource_type, class policy_type>
+template <class resource_manager_type>
+default_resource_store<resource_type, policy_type>::resource_sptr
+default_resource_store<resource_type, policy_type>::get_shared(hashed_path_view rsc_path,
+                                                               resource_manager_type& rsc_manager)
+{
+    return get_shared_cached_(rsc_path, [&]() {
+        if (resource_sptr rsc_sptr = find(rsc_path))
+            return rsc_sptr;
+        return get_shared_(std::filesystem::path(rsc_path.native()), file_loader_(rsc_manager));
+    });
+}
+
+template <class resource_type, class policy_type>
+default_resource_store<resource_type, policy_type>::resource_sptr
+default_resource_store<resource_type, policy_type>::get_shared(hashed_path_view rsc_path)
+{
+    return get_shared_cached_(rsc_path, [&]() {
+        if (resource_sptr rsc_sptr = find(rsc_path))
+            return rsc_sptr;
+        return get_shared_(std::filesystem::path(rsc_path.native()), file_loader_());
+    });
+}
+
+template <class resource_type, class policy_type>
+template <class resource_manager_type>
+default_resource_store<resource_type, policy_type>::resource_sptr
+default_resource_store<resource_type, policy_type>::load(const std::filesystem::path& rsc_path,
+                                                         resource_manager_type& rsc_manager, load_mode mode)
+{
+    return load_(rsc_path, mode, file_loader_(rsc_manager));
+}
 
+template <class resource_type, class policy_type>
+default_resource_store<resource_type, policy_type>::resource_sptr
+default_resource_store<resource_type, policy_type>::load(const std::filesystem::path& rsc_path, load_mode mode)
+{
+    return load_(rsc_path, mode, file_loader_());
+}
+
+template <class resource_type, class policy_type>
+template <class resource_manager_type>
+default_resource_store<resource_type, policy_type>::resource_sptr
+default_resource_store<resource_type, policy_type>::load(const std::filesystem::path& rsc_path,
+                                                         resource_manager_type& rsc_manager, std::nothrow_t)
+{
+    load_error error;
+    return load_(rsc_path, load_mode::force, nothrow_file_loader_(rsc_manager), &error);
+}
+
+template <class resource_type, class policy_type>
+default_resource_store<resource_type, policy_type>::resource_sptr
+default_resource_store<resource_type, policy_type>::load(const std::filesystem::path& rsc_path, std::nothrow_t)
+{
+    load_error error;
+    return load_(rsc_path, load_mode::force, nothrow_file_loader_(), &error);
+}
+
+template <class resource_type, class policy_type>
+template <class resource_manager_type, concepts::executor executor_type>
+resource_future<resource_type>
+default_resource_store<resource_type, policy_type>::get_shared_async(const std::filesystem::path& rsc_path,
+                                                                     resource_manager_type& rsc_manager,
+                                                                     executor_type& executor)
+{
+    return get_shared_async_(rsc_path, file_loader_(rsc_manager), executor);
+}
+
+template <class resource_type, class policy_type>
+template <concepts::executor executor_type>
+resource_future<resource_type>
+default_resource_store<resource_type, policy_type>::get_shared_async(const std::filesystem::path& rsc_path,
+                                                                     executor_type& executor)
+{
+    return get_shared_async_(rsc_path, file_loader_(), executor);
+}
+
+template <class resource_type, class policy_type>
+template <class resource_manager_type, concepts::executor executor_type>
+resource_future<resource_type>
+default_resource_store<resource_type, policy_type>::load_async(const std::filesystem::path& rsc_path,
+                                                               resource_manager_type& rsc_manager,
+                                                               executor_type& executor, load_mode mode)
+{
+    return submit_load_([this, rsc_path, &rsc_manager, mode]() { return load(rsc_path, rsc_manager, mode); },
+                        executor);
+}
+
+template <class resource_type, class policy_type>
+template <concepts::executor executor_type>
+resource_future<resource_type>
+default_resource_store<resource_type, policy_type>::load_async(const std::filesystem::path& rsc_path,
+                                                               executor_type& executor, load_mode mode)
+{
+    return submit_load_([this, rsc_path, mode]() { return load(rsc_path, mode); }, executor);
+}
+
+template <class resource_type, class policy_type>
+template <class resource_manager_type, concepts::executor executor_type>
+resource_preloading
+default_resource_store<resource_type, policy_type>::preload_async(std::span<const std::filesystem::path> rsc_paths,
+                                                                  resource_manager_type& rsc_manager,
+                                                                  executor_type& executor)
+{
+    return preload_async_(rsc_paths, file_loader_(rsc_manager), executor);
+}
+
+template <class resource_type, class policy_type>
+template <concepts::executor executor_type>
+resource_preloading
+default_resource_store<resource_type, policy_type>::preload_async(std::span<const std::filesystem::path> rsc_paths,
+                                                                  executor_type& executor)
+{
+    return preload_async_(rsc_paths, file_loader_(), executor);
+}
+
+template <class resource_type, class policy_type>
+template <class resource_manager_type>
+auto default_resource_store<resource_type, policy_type>::file_loader_(resource_manager_type& rsc_manager)
+{
     if constexpr (traits::is_loadable_resource_v<resource_type, resource_manager_type>)
     {
-        return load_canonical_(c_rsc_path, rsc_manager);
+        return [&rsc_manager](const std::filesystem::path& c_rsc_path) {
+            return load_resource_from_file<resource_type>(c_rsc_path, rsc_manager);
+        };
     }
     else
     {
-        return load_canonical_(c_rsc_path);
+        return file_loader_();
     }
 }
 
-template <class resource_type>
-default_resource_store<resource_type>::resource_sptr
-default_resource_store<resource_type>::get_shared(const std::filesystem::path& rsc_path)
+template <class resource_type, class policy_type>
+auto default_resource_store<resource_type, policy_type>::file_loader_()
 {
-    std::lock_guard lock(mutex_);
+    return [](const std::filesystem::path& c_rsc_path) { return load_resource_from_file<resource_type>(c_rsc_path); };
+}
 
-    auto iter = resources_.find(rsc_path);
-    if (iter != resources_.end())
-        return iter->second;
+template <class resource_type, class policy_type>
+template <class resource_manager_type>
+auto default_resource_store<resource_type, policy_type>::nothrow_file_loader_(resource_manager_type& rsc_manager)
+{
+    if constexpr (traits::is_loadable_resource_v<resource_type, resource_manager_type>)
+    {
+        return [&rsc_manager](const std::filesystem::path& c_rsc_path, std::error_code& error_code) {
+            return load_resource_from_file<resource_type>(c_rsc_path, rsc_manager, error_code);
+        };
+    }
+    else
+    {
+        return nothrow_file_loader_();
+    }
+}
+
+template <class resource_type, class policy_type>
+auto default_resource_store<resource_type, policy_type>::nothrow_file_loader_()
+{
+    return [](const std::filesystem::path& c_rsc_path, std::error_code& error_code) {
+        return load_resource_from_file<resource_type>(c_rsc_path, error_code);
+    };
+}
+
+template <class resource_type, class policy_type>
+template <class key_type>
+default_resource_store<resource_type, policy_type>::resource_shard&
+default_resource_store<resource_type, policy_type>::shard_(const key_type& rsc_path)
+{
+    if constexpr (policy_type::number_of_shards == 1)
+        return shards_.front();
+    else
+        return shards_[filesystem_path_hash{}(rsc_path) % policy_type::number_of_shards];
+}
 
-    std::filesystem::path c_rsc_path = std::filesystem::canonical(rsc_path);
-    iter = resources_.find(c_rsc_path);
-    if (iter != resources_.end())
+template <class resource_type, class policy_type>
+template <class key_type>
+default_resource_store<resource_type, policy_type>::resource_sptr
+default_resource_store<resource_type, policy_type>::find_(const key_type& rsc_path)
+{
+    resource_shard& shard = shard_(rsc_path);
+    if constexpr (policy_type::read_mostly)
+    {
+        resource_sptr rsc_sptr;
+        bool visited = shard.resources_snapshot.visit([&](const resource_dico& resources) {
+            if (auto iter = resources.find(rsc_path); iter != resources.end())
+                rsc_sptr = iter->second;
+        });
+        if (visited) [[likely]]
+            return rsc_sptr;
+    }
+
+    std::shared_lock lock(shard.mutex);
+    if (auto iter = shard.resources.find(rsc_path); iter != shard.resources.end())
         return iter->second;
+    return resource_sptr();
+}
 
-    return load_canonical_(c_rsc_path);
+template <class resource_type, class policy_type>
+default_resource_store<resource_type, policy_type>::resource_sptr
+default_resource_store<resource_type, policy_type>::find(path_string_view rsc_path)
+{
+    return find_spelling_(rsc_path);
 }
 
-template <class resource_type>
-template <class resource_manager_type>
-default_resource_store<resource_type>::resource_sptr
-default_resource_store<resource_type>::load(const std::filesystem::path& rsc_path, resource_manager_type& rsc_manager)
+template <class resource_type, class policy_type>
+default_resource_store<resource_type, policy_type>::resource_sptr
+default_resource_store<resource_type, policy_type>::find(hashed_path_view rsc_path)
 {
-    std::filesystem::path c_rsc_path = std::filesystem::canonical(rsc_path);
-    if constexpr (traits::is_loadable_resource_v<resource_type, resource_manager_type>)
+    return find_spelling_(rsc_path);
+}
+
+template <class resource_type, class policy_type>
+template <class key_type>
+default_resource_store<resource_type, policy_type>::resource_sptr
+default_resource_store<resource_type, policy_type>::find_spelling_(const key_type& rsc_path)
+{
+    if (resource_sptr rsc_sptr = find_(rsc_path))
+        return rsc_sptr;
+
+    using path_normalizer = typename policy_type::path_normalizer;
+    if constexpr (policy_type::cache_canonical_paths && path_normalizer::accesses_filesystem)
     {
-        return load_canonical_(c_rsc_path, rsc_manager);
+        std::shared_ptr<const hashed_path> c_rsc_path_sptr;
+        {
+            resource_shard& shard = shard_(rsc_path);
+            std::shared_lock lock(shard.mutex);
+            if (auto iter = shard.canonical_paths.find(rsc_path); iter != shard.canonical_paths.end())
+                c_rsc_path_sptr = iter->second;
+        }
+        if (c_rsc_path_sptr)
+            return find_(hashed_path_view(*c_rsc_path_sptr));
     }
+    return resource_sptr();
+}
+
+template <class resource_type, class policy_type>
+std::filesystem::path
+default_resource_store<resource_type, policy_type>::canonical_(const std::filesystem::path& rsc_path)
+{
+    std::error_code error_code;
+    std::filesystem::path c_rsc_path = canonical_(rsc_path, error_code);
+    if (error_code) [[unlikely]]
+        throw std::filesystem::filesystem_error("cannot make canonical path", rsc_path, error_code);
+    return c_rsc_path;
+}
+
+template <class resource_type, class policy_type>
+std::filesystem::path
+default_resource_store<resource_type, policy_type>::canonical_(const std::filesystem::path& rsc_path,
+                                                               std::error_code& error_code)
+{
+    using path_normalizer = typename policy_type::path_normalizer;
+    if constexpr (!policy_type::cache_canonical_paths || !path_normalizer::accesses_filesystem)
+        return path_normalizer::normalize(rsc_path, error_code);
     else
     {
-        return load_canonical_(c_rsc_path);
+        resource_shard& shard = shard_(rsc_path);
+        {
+            std::shared_lock lock(shard.mutex);
+            if (auto iter = shard.canonical_paths.find(rsc_path); iter != shard.canonical_paths.end())
+            {
+                error_code.clear();
+                return iter->second->path();
+            }
+        }
+
+        std::filesystem::path c_rsc_path = path_normalizer::normalize(rsc_path, error_code);
+        if (!error_code) [[likely]]
+        {
+            std::lock_guard lock(shard.mutex);
+            shard.canonical_paths.emplace(rsc_path, std::make_shared<const hashed_path>(c_rsc_path));
+        }
+        return c_rsc_path;
     }
 }
 
-template <class resource_type>
-default_resource_store<resource_type>::resource_sptr
-default_resource_store<resource_type>::load(const std::filesystem::path& rsc_path)
+template <class resource_type, class policy_type>
+void default_resource_store<resource_type, policy_type>::cache_canonical_path(
+    const std::filesystem::path& rsc_path, const std::filesystem::path& real_rsc_path)
+{
+    using path_normalizer = typename policy_type::path_normalizer;
+    if constexpr (policy_type::cache_canonical_paths && path_normalizer::accesses_filesystem)
+    {
+        std::error_code error_code;
+        std::filesystem::path c_rsc_path = canonical_(real_rsc_path, error_code);
+        if (error_code) [[unlikely]]
+            return;
+        resource_shard& shard = shard_(rsc_path);
+        std::lock_guard lock(shard.mutex);
+        shard.canonical_paths.emplace(rsc_path, std::make_shared<const hashed_path>(std::move(c_rsc_path)));
+    }
+}
+
+template <class resource_type, class policy_type>
+void default_resource_store<resource_type, policy_type>::invalidate_canonical_paths()
 {
-    std::filesystem::path c_rsc_path = std::filesystem::canonical(rsc_path);
-    return load_canonical_(c_rsc_path);
+    for (resource_shard& shard : shards_)
+    {
+        std::lock_guard lock(shard.mutex);
+        shard.canonical_paths.clear();
+        shard.failures.clear();
+    }
+    invalidate_thread_caches_();
 }
 
-template <class resource_type>
-default_resource_store<resource_type>::resource_sptr
-default_resource_store<resource_type>::load_canonical_(const std::filesystem::path& c_rsc_path)
+template <class resource_type, class policy_type>
+void default_resource_store<resource_type, policy_type>::forget_failures()
 {
-    resource_sptr rsc_sptr = load_resource_from_file<resource_type>(c_rsc_path);
-    return emplace_if_valid_(c_rsc_path, std::move(rsc_sptr));
+    for (resource_shard& shard : shards_)
+    {
+        std::lock_guard lock(shard.mutex);
+        shard.failures.clear();
+    }
 }
 
-template <class resource_type>
-template <class resource_manager_type>
-    requires traits::is_loadable_resource_v<resource_type, resource_manager_type>
-default_resource_store<resource_type>::resource_sptr
-default_resource_store<resource_type>::load_canonical_(const std::filesystem::path& c_rsc_path,
-                                                       resource_manager_type& rsc_manager)
+// The shard mutex is never held while the resource file is loaded: the first caller registers a shared future in
+// the loading resources of the shard, loads the file, then publishes the result. Concurrent callers asking for the
+// same canonical path wait on this future (or run the queued loading task if no loader thread has started it yet),
+// while lookups of other paths are not blocked.
+template <class resource_type, class policy_type>
+template <class loader_type>
+default_resource_store<resource_type, policy_type>::resource_sptr
+default_resource_store<resource_type, policy_type>::get_shared_(const std::filesystem::path& rsc_path,
+                                                                loader_type&& loader, load_error* error)
 {
-    resource_sptr rsc_sptr = load_resource_from_file<resource_type>(c_rsc_path, rsc_manager);
-    return emplace_if_valid_(c_rsc_path, std::move(rsc_sptr));
+    if (resource_sptr rsc_sptr = find_(rsc_path))
+        return rsc_sptr;
+    if (failure rsc_failure = find_failure_(rsc_path); rsc_failure.exception) [[unlikely]]
+        return report_failure_(error, rsc_failure.code, rsc_path, std::move(rsc_failure.exception));
+
+    std::error_code error_code;
+    std::filesystem::path c_rsc_path = canonical_(rsc_path, error_code);
+    if (error_code) [[unlikely]]
+    {
+        // The exception is only built if it is thrown or remembered.
+        std::exception_ptr exception;
+        if (!is_nothrow_loader_v<loader_type>
+            || policy_type::negative_cache_ttl > std::chrono::milliseconds::zero())
+        {
+            exception = std::make_exception_ptr(
+                std::filesystem::filesystem_error("cannot make canonical path", rsc_path, error_code));
+        }
+        if constexpr (policy_type::negative_cache_ttl > std::chrono::milliseconds::zero())
+        {
+            resource_shard& shard = shard_(rsc_path);
+            std::lock_guard lock(shard.mutex);
+            remember_failure_(shard, rsc_path, exception, error_code);
+        }
+        return report_failure_(error, error_code, rsc_path, std::move(exception));
+    }
+    if (c_rsc_path.native() != rsc_path.native())
+    {
+        if (resource_sptr rsc_sptr = find_(c_rsc_path))
+            return rsc_sptr;
+        if (failure rsc_failure = find_failure_(c_rsc_path); rsc_failure.exception) [[unlikely]]
+            return report_failure_(error, rsc_failure.code, c_rsc_path, std::move(rsc_failure.exception));
+    }
+    return get_or_load_(c_rsc_path, loader, error);
 }
 
-template <class resource_type>
-default_resource_store<resource_type>::resource_sptr
-default_resource_store<resource_type>::emplace_if_valid_(const std::filesystem::path& c_rsc_path,
-                                                         resource_sptr rsc_sptr)
+template <class resource_type, class policy_type>
+template <class loader_type>
+default_resource_store<resource_type, policy_type>::resource_sptr
+default_resource_store<resource_type, policy_type>::get_or_load_(const std::filesystem::path& c_rsc_path,
+                                                                 loader_type&& loader, load_error* error)
 {
-    if (rsc_sptr) [[likely]]
+    resource_shard& shard = shard_(c_rsc_path);
+    std::promise<resource_sptr> rsc_promise;
     {
-        std::lock_guard lock(mutex_);
-        resources_.emplace(c_rsc_path, rsc_sptr);
-        return rsc_sptr;
+        std::unique_lock lock(shard.mutex);
+        if (auto iter = shard.resources.find(c_rsc_path); iter != shard.resources.end())
+            return iter->second;
+        if (auto iter = shard.loading_resources.find(c_rsc_path); iter != shard.loading_resources.end())
+        {
+            iter->second.joined = true;
+            resource_future<resource_type> rsc_future(iter->second.future, iter->second.task);
+            lock.unlock();
+            if constexpr (!is_nothrow_loader_v<loader_type>)
+                return rsc_future.get();
+            else
+            {
+                try
+                {
+                    return rsc_future.get();
+                }
+                catch (...)
+                {
+                    return report_failure_(error, error_code_of(std::current_exception()), c_rsc_path, nullptr);
+                }
+            }
+        }
+        shard.loading_resources.emplace(c_rsc_path, loading_resource{ rsc_promise.get_future().share(), nullptr });
     }
+
+    if constexpr (is_nothrow_loader_v<loader_type>)
+        return load_and_publish_(shard, c_rsc_path, rsc_promise, loader, *error);
     else
+        return load_and_publish_(shard, c_rsc_path, rsc_promise, loader);
+}
+
+template <class resource_type, class policy_type>
+template <class loader_type, class executor_type>
+resource_future<resource_type>
+default_resource_store<resource_type, policy_type>::get_shared_async_(const std::filesystem::path& rsc_path,
+                                                                      loader_type&& loader, executor_type& executor)
+{
+    if (resource_sptr rsc_sptr = find_(rsc_path))
+        return resource_future<resource_type>::make_ready(std::move(rsc_sptr));
+    if (failure rsc_failure = find_failure_(rsc_path); rsc_failure.exception) [[unlikely]]
+        return resource_future<resource_type>::make_exceptional(std::move(rsc_failure.exception));
+
+    std::error_code error_code;
+    std::filesystem::path c_rsc_path = canonical_(rsc_path, error_code);
+    if (error_code) [[unlikely]]
+    {
+        std::filesystem::filesystem_error error("cannot make canonical path", rsc_path, error_code);
+        std::exception_ptr exception = std::make_exception_ptr(std::move(error));
+        if constexpr (policy_type::negative_cache_ttl > std::chrono::milliseconds::zero())
+        {
+            resource_shard& shard = shard_(rsc_path);
+            std::lock_guard lock(shard.mutex);
+            remember_failure_(shard, rsc_path, exception, error_code);
+        }
+        return resource_future<resource_type>::make_exceptional(std::move(exception));
+    }
+    if (failure rsc_failure = find_failure_(c_rsc_path); rsc_failure.exception) [[unlikely]]
+        return resource_future<resource_type>::make_exceptional(std::move(rsc_failure.exception));
+
+    resource_shard& shard = shard_(c_rsc_path);
+    std::unique_lock lock(shard.mutex);
+    if (auto iter = shard.resources.find(c_rsc_path); iter != shard.resources.end())
+        return resource_future<resource_type>::make_ready(iter->second);
+    if (auto iter = shard.loading_resources.find(c_rsc_path); iter != shard.loading_resources.end())
+    {
+        iter->second.joined = true;
+        return resource_future<resource_type>(iter->second.future, iter->second.task);
+    }
+
+    std::shared_ptr rsc_promise = std::make_shared<std::promise<resource_sptr>>();
+    std::shared_future<resource_sptr> rsc_future = rsc_promise->get_future().share();
+    std::shared_ptr task = std::make_shared<resource_loading_task>(
+        [this, &shard, c_rsc_path, rsc_promise, loader = std::forward<loader_type>(loader)]() mutable {
+            try
+            {
+                load_and_publish_(shard, c_rsc_path, *rsc_promise, loader);
+            }
+            catch (...)
+            {
+                // The exception is stored in the shared future.
+            }
+        });
+    shard.loading_resources.emplace(c_rsc_path, loading_resource{ rsc_future, task });
+    lock.unlock();
+
+    executor.submit([task]() { task->try_run(); });
+    return resource_future<resource_type>(std::move(rsc_future), std::move(task));
+}
+
+// The loadings in progress are registered in the loading resources of the shard, as by get_shared_(), so that a
+// loading is never concurrent with another loading of the same canonical path.
+template <class resource_type, class policy_type>
+template <class loader_type>
+default_resource_store<resource_type, policy_type>::resource_sptr
+default_resource_store<resource_type, policy_type>::load_(const std::filesystem::path& rsc_path, load_mode mode,
+                                                          loader_type&& loader, load_error* error)
+{
+    std::filesystem::path c_rsc_path;
+    if constexpr (is_nothrow_loader_v<loader_type>)
+    {
+        std::error_code error_code;
+        c_rsc_path = canonical_(rsc_path, error_code);
+        if (error_code) [[unlikely]]
+            return report_failure_(error, error_code, rsc_path, nullptr);
+    }
+    else
+        c_rsc_path = canonical_(rsc_path);
+    resource_shard& shard = shard_(c_rsc_path);
+    std::promise<resource_sptr> rsc_promise;
+    for (;;)
+    {
+        std::unique_lock lock(shard.mutex);
+        auto iter = shard.loading_resources.find(c_rsc_path);
+        if (iter == shard.loading_resources.end())
+        {
+            shard.loading_resources.emplace(c_rsc_path, loading_resource{ rsc_promise.get_future().share(), nullptr });
+            break;
+        }
+        iter->second.joined = true;
+        resource_future<resource_type> rsc_future(iter->second.future, iter->second.task);
+        lock.unlock();
+        if (mode == load_mode::join)
+        {
+            if constexpr (!is_nothrow_loader_v<loader_type>)
+                return rsc_future.get();
+            else
+            {
+                try
+                {
+                    return rsc_future.get();
+                }
+                catch (...)
+                {
+                    return report_failure_(error, error_code_of(std::current_exception()), c_rsc_path, nullptr);
+                }
+            }
+        }
+        // Another loading may have been registered when this one ends: it is waited for too.
+        rsc_future.wait();
+    }
+    if constexpr (is_nothrow_loader_v<loader_type>)
+        return load_and_publish_(shard, c_rsc_path, rsc_promise, loader, *error, false);
+    else
+        return load_and_publish_(shard, c_rsc_path, rsc_promise, loader, false);
+}
+
+template <class resource_type, class policy_type>
+template <class loader_type>
+default_resource_store<resource_type, policy_type>::resource_sptr
+default_resource_store<resource_type, policy_type>::load_and_publish_(resource_shard& shard,
+                                                                      const std::filesystem::path& c_rsc_path,
+                                                                      std::promise<resource_sptr>& rsc_promise,
+                                                                      loader_type& loader, bool return_stored_resource)
+{
+    try
+    {
+        resource_sptr rsc_sptr = loader(c_rsc_path);
+        if (!rsc_sptr) [[unlikely]]
+            throw_resource_not_loaded_(c_rsc_path);
+        rsc_sptr = publish_(shard, c_rsc_path, std::move(rsc_sptr), return_stored_resource);
+        rsc_promise.set_value(rsc_sptr);
+        return rsc_sptr;
+    }
+    catch (...)
+    {
+        {
+            std::lock_guard lock(shard.mutex);
+            shard.loading_resources.erase(c_rsc_path);
+            remember_failure_(shard, c_rsc_path, std::current_exception());
+        }
+        rsc_promise.set_exception(std::current_exception());
+        throw;
+    }
+}
+
+template <class resource_type, class policy_type>
+template <class loader_type>
+default_resource_store<resource_type, policy_type>::resource_sptr
+default_resource_store<resource_type, policy_type>::load_and_publish_(resource_shard& shard,
+                                                                      const std::filesystem::path& c_rsc_path,
+                                                                      std::promise<resource_sptr>& rsc_promise,
+                                                                      loader_type& loader, load_error& error,
+                                                                      bool return_stored_resource)
+{
+    std::error_code error_code;
+    if (resource_sptr rsc_sptr = loader(c_rsc_path, error_code)) [[likely]]
+    {
+        rsc_sptr = publish_(shard, c_rsc_path, std::move(rsc_sptr), return_stored_resource);
+        rsc_promise.set_value(rsc_sptr);
+        return rsc_sptr;
+    }
+    error = load_error{ error_code, c_rsc_path };
+    std::exception_ptr exception;
+    if constexpr (policy_type::negative_cache_ttl > std::chrono::milliseconds::zero())
+        exception = make_exception_(error);
+    bool joined = false;
+    {
+        std::lock_guard lock(shard.mutex);
+        if (auto iter = shard.loading_resources.find(c_rsc_path); iter != shard.loading_resources.end())
+        {
+            joined = iter->second.joined;
+            shard.loading_resources.erase(iter);
+        }
+        remember_failure_(shard, c_rsc_path, exception, error_code);
+    }
+    if (joined) [[unlikely]]
+        rsc_promise.set_exception(exception ? std::move(exception) : make_exception_(error));
+    return resource_sptr();
+}
+
+template <class resource_type, class policy_type>
+default_resource_store<resource_type, policy_type>::resource_sptr
+default_resource_store<resource_type, policy_type>::publish_(resource_shard& shard,
+                                                             const std::filesystem::path& c_rsc_path,
+                                                             resource_sptr rsc_sptr, bool return_stored_resource)
+{
+    std::lock_guard lock(shard.mutex);
+    auto [iter, inserted] = shard.resources.emplace(c_rsc_path, rsc_sptr);
+    if (return_stored_resource)
+        rsc_sptr = iter->second;
+    shard.loading_resources.erase(c_rsc_path);
+    forget_failure_(shard, c_rsc_path);
+    if (inserted)
+    {
+        shard.publish_resources();
+        update_slot_(shard, c_rsc_path, rsc_sptr);
+    }
+    return rsc_sptr;
+}
+
+template <class resource_type, class policy_type>
+template <class load_function_type, class executor_type>
+resource_future<resource_type>
+default_resource_store<resource_type, policy_type>::submit_load_(load_function_type&& load_function,
+                                                                 executor_type& executor)
+{
+    std::shared_ptr rsc_promise = std::make_shared<std::promise<resource_sptr>>();
+    std::shared_future<resource_sptr> rsc_future = rsc_promise->get_future().share();
+    std::shared_ptr task = std::make_shared<resource_loading_task>(
+        [rsc_promise, load_function = std::forward<load_function_type>(load_function)]() mutable {
+            try
+            {
+                rsc_promise->set_value(load_function());
+            }
+            catch (...)
+            {
+                rsc_promise->set_exception(std::current_exception());
+            }
+        });
+    executor.submit([task]() { task->try_run(); });
+    return resource_future<resource_type>(std::move(rsc_future), std::move(task));
+}
+
+// Each shard is locked once to register the loadings, and once to insert the loaded resources. The promise of a
+// resource is fulfilled as soon as it is loaded, so that a loader waiting for another resource of the batch does
+// not wait for the whole batch.
+template <class resource_type, class policy_type>
+template <class loader_type, class executor_type>
+resource_preloading
+default_resource_store<resource_type, policy_type>::preload_async_(std::span<const std::filesystem::path> rsc_paths,
+                                                                   loader_type&& loader, executor_type& executor)
+{
+    struct preloaded_resource
+    {
+        std::filesystem::path rsc_path;
+        std::filesystem::path c_rsc_path;
+        resource_shard* shard = nullptr;
+        resource_future<resource_type> future;
+        // True if the loading was registered by this preloading, false if it was already in progress.
+        bool owned = false;
+    };
+
+    struct preloading_state
+    {
+        std::vector<preloaded_resource> resources;
+        std::vector<resource_load_failure> failures;
+    };
+
+    std::shared_ptr state = std::make_shared<preloading_state>();
+    state->resources.reserve(rsc_paths.size());
+    for (const std::filesystem::path& rsc_path : rsc_paths)
+    {
+        if (failure rsc_failure = find_failure_(rsc_path); rsc_failure.exception) [[unlikely]]
+        {
+            state->failures.push_back(resource_load_failure{ rsc_path, std::move(rsc_failure.exception) });
+            continue;
+        }
+        std::error_code error_code;
+        std::filesystem::path c_rsc_path = canonical_(rsc_path, error_code);
+        if (error_code) [[unlikely]]
+        {
+            std::filesystem::filesystem_error error("cannot make canonical path", rsc_path, error_code);
+            std::exception_ptr exception = std::make_exception_ptr(std::move(error));
+            if constexpr (policy_type::negative_cache_ttl > std::chrono::milliseconds::zero())
+            {
+                resource_shard& shard = shard_(rsc_path);
+                std::lock_guard lock(shard.mutex);
+                remember_failure_(shard, rsc_path, exception, error_code);
+            }
+            state->failures.push_back(resource_load_failure{ rsc_path, std::move(exception) });
+            continue;
+        }
+        resource_shard& shard = shard_(c_rsc_path);
+        state->resources.push_back(preloaded_resource{ rsc_path, std::move(c_rsc_path), &shard, {}, false });
+    }
+
+    std::ranges::sort(state->resources, [](const preloaded_resource& left, const preloaded_resource& right) {
+        if (left.shard != right.shard)
+            return left.shard < right.shard;
+        return left.c_rsc_path.native() < right.c_rsc_path.native();
+    });
+    auto native_path = [](const preloaded_resource& rsc) -> const std::filesystem::path::string_type& {
+        return rsc.c_rsc_path.native();
+    };
+    auto duplicates = std::ranges::unique(state->resources, std::ranges::equal_to{}, native_path);
+    state->resources.erase(duplicates.begin(), duplicates.end());
+
+    std::vector<std::shared_ptr<resource_loading_task>> tasks;
+    auto shard_begin = state->resources.begin();
+    while (shard_begin != state->resources.end())
+    {
+        resource_shard& shard = *shard_begin->shard;
+        auto shard_end = std::find_if(shard_begin, state->resources.end(),
+                                      [&shard](const preloaded_resource& rsc) { return rsc.shard != &shard; });
+        std::lock_guard lock(shard.mutex);
+        for (auto iter = shard_begin; iter != shard_end; ++iter)
+        {
+            if (auto rsc_iter = shard.resources.find(iter->c_rsc_path); rsc_iter != shard.resources.end())
+                iter->future = resource_future<resource_type>::make_ready(rsc_iter->second);
+            else if (auto loading_iter = shard.loading_resources.find(iter->c_rsc_path);
+                     loading_iter != shard.loading_resources.end())
+            {
+                loading_iter->second.joined = true;
+                iter->future = resource_future<resource_type>(loading_iter->second.future, loading_iter->second.task);
+            }
+            else
+            {
+                std::shared_ptr rsc_promise = std::make_shared<std::promise<resource_sptr>>();
+                std::shared_future<resource_sptr> rsc_future = rsc_promise->get_future().share();
+                std::shared_ptr task = std::make_shared<resource_loading_task>(
+                    [this, c_rsc_path = iter->c_rsc_path, rsc_promise, loader]() mutable {
+                        try
+                        {
+                            resource_sptr rsc_sptr = loader(c_rsc_path);
+                            if (!rsc_sptr) [[unlikely]]
+                                throw_resource_not_loaded_(c_rsc_path);
+                            rsc_promise->set_value(std::move(rsc_sptr));
+                        }
+                        catch (...)
+                        {
+                            rsc_promise->set_exception(std::current_exception());
+                        }
+                    });
+                shard.loading_resources.emplace(iter->c_rsc_path, loading_resource{ rsc_future, task });
+                iter->future = resource_future<resource_type>(std::move(rsc_future), task);
+                iter->owned = true;
+                tasks.push_back(std::move(task));
+            }
+        }
+        shard_begin = shard_end;
+    }
+
+    for (const std::shared_ptr<resource_loading_task>& task : tasks)
+        executor.submit([task]() { task->try_run(); });
+
+    return resource_preloading([this, state = std::move(state)]() {
+        std::vector<resource_sptr> rsc_sptrs(state->resources.size());
+        std::vector<std::exception_ptr> exceptions(state->resources.size());
+        for (std::size_t i = 0; i < state->resources.size(); ++i)
+        {
+            try
+            {
+                rsc_sptrs[i] = state->resources[i].future.get();
+            }
+            catch (...)
+            {
+                exceptions[i] = std::current_exception();
+                const std::filesystem::path& rsc_path = state->resources[i].rsc_path;
+                state->failures.push_back(resource_load_failure{ rsc_path, exceptions[i] });
+            }
+        }
+
+        for (std::size_t i = 0; i < state->resources.size();)
+        {
+            resource_shard& shard = *state->resources[i].shard;
+            bool modified = false;
+            std::lock_guard lock(shard.mutex);
+            for (; i < state->resources.size() && state->resources[i].shard == &shard; ++i)
+            {
+                preloaded_resource& rsc = state->resources[i];
+                if (!rsc.owned)
+                    continue;
+                if (!rsc_sptrs[i]) [[unlikely]]
+                    remember_failure_(shard, rsc.c_rsc_path, exceptions[i]);
+                else
+                {
+                    forget_failure_(shard, rsc.c_rsc_path);
+                    if (shard.resources.emplace(rsc.c_rsc_path, rsc_sptrs[i]).second)
+                    {
+                        update_slot_(shard, rsc.c_rsc_path, rsc_sptrs[i]);
+                        modified = true;
+                    }
+                }
+                shard.loading_resources.erase(rsc.c_rsc_path);
+            }
+            if (modified)
+                shard.publish_resources();
+        }
+
+        return std::move(state->failures);
+    });
+}
+
+template <class resource_type, class policy_type>
+void default_resource_store<resource_type, policy_type>::throw_resource_not_loaded_(
+    const std::filesystem::path& c_rsc_path)
+{
+    std::rethrow_exception(make_exception_(load_error{ load_errc::resource_not_loaded, c_rsc_path }));
+}
+
+template <class resource_type, class policy_type>
+std::exception_ptr default_resource_store<resource_type, policy_type>::make_exception_(const load_error& error)
+{
+    if (error.code == load_errc::resource_not_loaded)
     {
         std::string err_str = std::format("The resource file \"{}\" was not loaded correctly (nullptr returned).",
-                                          c_rsc_path.generic_string());
-        throw std::runtime_error(err_str);
+                                          error.path.generic_string());
+        return std::make_exception_ptr(std::runtime_error(err_str));
     }
+    return std::make_exception_ptr(std::filesystem::filesystem_error("cannot load resource", error.path, error.code));
 }
 
-template <class resource_type>
-bool default_resource_store<resource_type>::insert(const std::filesystem::path& rsc_path, resource_sptr rsc_sptr)
+template <class resource_type, class policy_type>
+default_resource_store<resource_type, policy_type>::resource_sptr
+default_resource_store<resource_type, policy_type>::report_failure_(load_error* error, std::error_code code,
+                                                                    const std::filesystem::path& rsc_path,
+                                                                    std::exception_ptr exception)
+{
+    if (!error)
+        std::rethrow_exception(std::move(exception));
+    *error = load_error{ code, rsc_path };
+    return resource_sptr();
+}
+
+template <class resource_type, class policy_type>
+default_resource_store<resource_type, policy_type>::failure
+default_resource_store<resource_type, policy_type>::find_failure_(const std::filesystem::path& rsc_path)
+{
+    if constexpr (policy_type::negative_cache_ttl > std::chrono::milliseconds::zero())
+    {
+        resource_shard& shard = shard_(rsc_path);
+        std::shared_lock lock(shard.mutex);
+        if (shard.failures.empty()) [[likely]]
+            return failure();
+        if (auto iter = shard.failures.find(rsc_path); iter != shard.failures.end())
+        {
+            // An expired failure is replaced by the next one, or erased by the next loading.
+            if constexpr (policy_type::negative_cache_ttl == std::chrono::milliseconds::max())
+                return iter->second;
+            else if (std::chrono::steady_clock::now() < iter->second.expiry)
+                return iter->second;
+        }
+    }
+    return failure();
+}
+
+template <class resource_type, class policy_type>
+void default_resource_store<resource_type, policy_type>::remember_failure_(resource_shard& shard,
+                                                                           const std::filesystem::path& rsc_path,
+                                                                           std::exception_ptr exception,
+                                                                           std::error_code code)
+{
+    if constexpr (policy_type::negative_cache_ttl > std::chrono::milliseconds::zero())
+    {
+        std::chrono::steady_clock::time_point expiry = std::chrono::steady_clock::time_point::max();
+        if constexpr (policy_type::negative_cache_ttl != std::chrono::milliseconds::max())
+            expiry = std::chrono::steady_clock::now() + policy_type::negative_cache_ttl;
+        if (!code)
+            code = error_code_of(exception);
+        shard.failures[rsc_path] = failure{ std::move(exception), code, expiry };
+    }
+}
+
+template <class resource_type, class policy_type>
+void default_resource_store<resource_type, policy_type>::forget_failure_(resource_shard& shard,
+                                                                         const std::filesystem::path& rsc_path)
+{
+    if constexpr (policy_type::negative_cache_ttl > std::chrono::milliseconds::zero())
+    {
+        if (!shard.failures.empty())
+            shard.failures.erase(rsc_path);
+    }
+}
+
+template <class resource_type, class policy_type>
+bool default_resource_store<resource_type, policy_type>::insert(const std::filesystem::path& rsc_path,
+                                                                resource_sptr rsc_sptr)
 {
     assert(rsc_sptr);
-    std::lock_guard lock(mutex_);
-    return resources_.insert(typename resource_dico::value_type(rsc_path, std::move(rsc_sptr))).second;
+    resource_shard& shard = shard_(rsc_path);
+    std::lock_guard lock(shard.mutex);
+    auto [iter, inserted] = shard.resources.emplace(rsc_path, std::move(rsc_sptr));
+    if (!inserted)
+        return false;
+    forget_failure_(shard, rsc_path);
+    shard.publish_resources();
+    update_slot_(shard, rsc_path, iter->second);
+    return true;
 }
 
-template <class resource_type>
-void default_resource_store<resource_type>::set(const std::filesystem::path& rsc_path, resource_sptr rsc_sptr)
+template <class resource_type, class policy_type>
+void default_resource_store<resource_type, policy_type>::set(const std::filesystem::path& rsc_path,
+                                                             resource_sptr rsc_sptr)
 {
     assert(rsc_sptr);
-    std::lock_guard lock(mutex_);
-    resources_[rsc_path] = std::move(rsc_sptr);
+    resource_shard& shard = shard_(rsc_path);
+    std::lock_guard lock(shard.mutex);
+    resource_sptr& stored_rsc_sptr = shard.resources[rsc_path];
+    stored_rsc_sptr = std::move(rsc_sptr);
+    forget_failure_(shard, rsc_path);
+    shard.publish_resources();
+    update_slot_(shard, rsc_path, stored_rsc_sptr);
+    invalidate_thread_caches_();
 }
 
-template <class resource_type>
-void default_resource_store<resource_type>::remove(const std::filesystem::path& rsc_path)
+template <class resource_type, class policy_type>
+void default_resource_store<resource_type, policy_type>::remove(const std::filesystem::path& rsc_path)
+{
+    {
+        resource_shard& shard = shard_(rsc_path);
+        std::lock_guard lock(shard.mutex);
+        if (shard.resources.erase(rsc_path) != 0)
+        {
+            shard.publish_resources();
+            update_slot_(shard, rsc_path, nullptr);
+            invalidate_thread_caches_();
+            return;
+        }
+    }
+
+    std::filesystem::path c_rsc_path = canonical_(rsc_path);
+    resource_shard& shard = shard_(c_rsc_path);
+    std::lock_guard lock(shard.mutex);
+    if (shard.resources.erase(c_rsc_path) != 0)
+    {
+        shard.publish_resources();
+        update_slot_(shard, c_rsc_path, nullptr);
+        invalidate_thread_caches_();
+    }
+}
+
+template <class resource_type, class policy_type>
+resource_id<resource_type>
+default_resource_store<resource_type, policy_type>::intern(const std::filesystem::path& rsc_path)
+{
+    std::filesystem::path c_rsc_path = canonical_(rsc_path);
+    resource_shard& shard = shard_(c_rsc_path);
+    std::lock_guard lock(shard.mutex);
+    if (auto iter = shard.resource_ids.find(c_rsc_path); iter != shard.resource_ids.end())
+        return resource_id<resource_type>(iter->second);
+
+    std::size_t slot_index = 0;
+    {
+        std::lock_guard slots_lock(slots_mutex_);
+        slot_index = slots_.append([&](resource_slot& slot) {
+            slot.path = c_rsc_path;
+            if (auto iter = shard.resources.find(c_rsc_path); iter != shard.resources.end())
+                (void)slot.assign(iter->second);
+        });
+    }
+    assert(slot_index < std::numeric_limits<std::uint32_t>::max());
+    shard.resource_ids.emplace(std::move(c_rsc_path), static_cast<std::uint32_t>(slot_index));
+    return resource_id<resource_type>(static_cast<std::uint32_t>(slot_index));
+}
+
+template <class resource_type, class policy_type>
+template <class resource_manager_type>
+default_resource_store<resource_type, policy_type>::resource_sptr
+default_resource_store<resource_type, policy_type>::get_shared(resource_id<resource_type> rsc_id,
+                                                               resource_manager_type& rsc_manager)
+{
+    return get_shared_(rsc_id, file_loader_(rsc_manager));
+}
+
+template <class resource_type, class policy_type>
+default_resource_store<resource_type, policy_type>::resource_sptr
+default_resource_store<resource_type, policy_type>::get_shared(resource_id<resource_type> rsc_id)
+{
+    return get_shared_(rsc_id, file_loader_());
+}
+
+template <class resource_type, class policy_type>
+template <class loader_type>
+default_resource_store<resource_type, policy_type>::resource_sptr
+default_resource_store<resource_type, policy_type>::get_shared_(resource_id<resource_type> rsc_id,
+                                                                loader_type&& loader)
+{
+    resource_slot& slot = slot_(rsc_id);
+    // The mutex of the slot is only locked to copy the shared pointer of a stored resource.
+    if (slot.rsc_ptr.load(std::memory_order_acquire)) [[likely]]
+    {
+        std::lock_guard lock(slot.mutex);
+        if (slot.rsc_sptr) [[likely]]
+            return slot.rsc_sptr;
+    }
+    return get_shared_(slot.path, std::forward<loader_type>(loader));
+}
+
+template <class resource_type, class policy_type>
+template <class resource_manager_type>
+resource_handle<resource_type>
+default_resource_store<resource_type, policy_type>::get_handle(const std::filesystem::path& rsc_path,
+                                                               resource_manager_type& rsc_manager)
+{
+    return get_handle_(intern(rsc_path), file_loader_(rsc_manager));
+}
+
+template <class resource_type, class policy_type>
+resource_handle<resource_type>
+default_resource_store<resource_type, policy_type>::get_handle(const std::filesystem::path& rsc_path)
+{
+    return get_handle_(intern(rsc_path), file_loader_());
+}
+
+template <class resource_type, class policy_type>
+template <class resource_manager_type>
+resource_handle<resource_type>
+default_resource_store<resource_type, policy_type>::get_handle(resource_id<resource_type> rsc_id,
+                                                               resource_manager_type& rsc_manager)
+{
+    return get_handle_(rsc_id, file_loader_(rsc_manager));
+}
+
+template <class resource_type, class policy_type>
+resource_handle<resource_type>
+default_resource_store<resource_type, policy_type>::get_handle(resource_id<resource_type> rsc_id)
+{
+    return get_handle_(rsc_id, file_loader_());
+}
+
+template <class resource_type, class policy_type>
+template <class loader_type>
+resource_handle<resource_type>
+default_resource_store<resource_type, policy_type>::get_handle_(resource_id<resource_type> rsc_id,
+                                                                loader_type&& loader)
+{
+    resource_slot& slot = slot_(rsc_id);
+    for (;;)
+    {
+        // No lock: the generation read after the pointer is at least the one of the pointer, and the handle checks it
+        // again when dereferenced.
+        if (slot.rsc_ptr.load(std::memory_order_acquire)) [[likely]]
+            return resource_handle<resource_type>(slot, rsc_id, slot.generation.load(std::memory_order_relaxed));
+        // Publishes the loaded resource in the slot, unless it is removed again in the meantime.
+        get_shared_(slot.path, loader);
+    }
+}
+
+template <class resource_type, class policy_type>
+default_resource_store<resource_type, policy_type>::resource_slot&
+default_resource_store<resource_type, policy_type>::slot_(resource_id<resource_type> rsc_id)
+{
+    if (rsc_id.index() >= slots_.size()) [[unlikely]]
+        throw std::out_of_range(std::format("Invalid resource id: {}.", rsc_id.index()));
+    return slots_[rsc_id.index()];
+}
+
+template <class resource_type, class policy_type>
+void default_resource_store<resource_type, policy_type>::update_slot_(resource_shard& shard,
+                                                                      const std::filesystem::path& rsc_path,
+                                                                      const resource_sptr& rsc_sptr)
+{
+    if (shard.resource_ids.empty()) [[likely]]
+        return;
+    if (auto iter = shard.resource_ids.find(rsc_path); iter != shard.resource_ids.end())
+    {
+        resource_slot& slot = slots_[iter->second];
+        // Declared before the lock, so that the previous resource is released once the slot is unlocked.
+        resource_sptr old_rsc_sptr;
+        std::lock_guard lock(slot.mutex);
+        old_rsc_sptr = slot.assign(rsc_sptr);
+    }
+}
+
+template <class resource_type, class policy_type>
+template <class key_type, class lookup_function_type>
+default_resource_store<resource_type, policy_type>::resource_sptr
+default_resource_store<resource_type, policy_type>::get_shared_cached_(const key_type& rsc_path,
+                                                                       lookup_function_type&& lookup_function)
+{
+    if constexpr (policy_type::thread_cache_size == 0)
+        return lookup_function();
+    else
+    {
+        constexpr std::size_t number_of_sets = policy_type::thread_cache_size / 2;
+        static_assert(number_of_sets > 0);
+        thread_local std::array<thread_cache_entry, policy_type::thread_cache_size> thread_cache;
+
+        const std::size_t hash = filesystem_path_hash{}(rsc_path);
+        // Read before the lookup: if a resource is replaced after it, the cached entry is already stale.
+        const std::uint64_t epoch = epoch_.load(std::memory_order_acquire);
+        // The most recently used entry of a set is its first one.
+        thread_cache_entry* set = &thread_cache[(hash % number_of_sets) * 2];
+        auto matches = [&](const thread_cache_entry& entry) {
+            return entry.store_id == store_id_ && entry.epoch == epoch && entry.hash == hash
+                   && filesystem_path_equal{}(entry.rsc_path, rsc_path);
+        };
+        if (matches(set[0])) [[likely]]
+            return set[0].rsc_sptr;
+        if (matches(set[1]))
+        {
+            std::swap(set[0], set[1]);
+            return set[0].rsc_sptr;
+        }
+
+        resource_sptr rsc_sptr = lookup_function();
+        // A failure is not cached, so that it is not remembered longer than by the store.
+        if (!rsc_sptr) [[unlikely]]
+            return rsc_sptr;
+        // The least recently used entry is replaced.
+        std::swap(set[0], set[1]);
+        thread_cache_entry& entry = set[0];
+        if constexpr (std::is_same_v<key_type, path_string_view>)
+            entry.rsc_path = rsc_path;
+        else
+            entry.rsc_path = rsc_path.native();
+        entry.store_id = store_id_;
+        entry.epoch = epoch;
+        entry.hash = hash;
+        entry.rsc_sptr = rsc_sptr;
+        return rsc_sptr;
+    }
+}
+
+template <class resource_type, class policy_type>
+void default_resource_store<resource_type, policy_type>::invalidate_thread_caches_()
 {
-    if (resources_.erase(rsc_path) == 0)
-        resources_.erase(std::filesystem::canonical(rsc_path));
+    if constexpr (policy_type::thread_cache_size > 0)
+        epoch_.fetch_add(1, std::memory_order_release);
 }
 
 template <class resource_type>
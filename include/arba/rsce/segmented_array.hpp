@@ -0,0 +1,85 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <memory>
+
+inline namespace arba
+{
+namespace rsce
+{
+
+// Array whose elements never move: they are allocated in segments of doubling sizes, so that an element can be
+// accessed while other elements are appended. Appends must be serialized by the caller, but need no synchronization
+// with the accesses to the elements already appended.
+template <class value_type, std::size_t first_segment_size = 64>
+class segmented_array
+{
+    static_assert(std::has_single_bit(first_segment_size));
+
+public:
+    segmented_array() = default;
+    segmented_array(const segmented_array&) = delete;
+    segmented_array& operator=(const segmented_array&) = delete;
+    ~segmented_array()
+    {
+        for (std::atomic<value_type*>& segment : segments_)
+            delete[] segment.load(std::memory_order_relaxed);
+    }
+
+    inline std::size_t size() const noexcept { return size_.load(std::memory_order_acquire); }
+
+    // index must be lower than size().
+    inline value_type& operator[](std::size_t index) noexcept
+    {
+        assert(index < size());
+        const std::size_t segment_index = segment_index_(index);
+        value_type* segment = segments_[segment_index].load(std::memory_order_acquire);
+        return segment[index - segment_begin_(segment_index)];
+    }
+
+    inline const value_type& operator[](std::size_t index) const noexcept
+    {
+        return const_cast<segmented_array&>(*this)[index];
+    }
+
+    // Default-constructs a new element, initializes it with init_function, then makes it accessible.
+    // Returns its index.
+    template <class init_function_type>
+    std::size_t append(init_function_type&& init_function)
+    {
+        const std::size_t index = size_.load(std::memory_order_relaxed);
+        const std::size_t segment_index = segment_index_(index);
+        value_type* segment = segments_[segment_index].load(std::memory_order_relaxed);
+        if (!segment)
+        {
+            segment = new value_type[first_segment_size << segment_index];
+            segments_[segment_index].store(segment, std::memory_order_release);
+        }
+        init_function(segment[index - segment_begin_(segment_index)]);
+        size_.store(index + 1, std::memory_order_release);
+        return index;
+    }
+
+private:
+    inline static std::size_t segment_index_(std::size_t index) noexcept
+    {
+        return std::bit_width(index / first_segment_size + 1) - 1;
+    }
+
+    inline static std::size_t segment_begin_(std::size_t segment_index) noexcept
+    {
+        return first_segment_size * ((std::size_t(1) << segment_index) - 1);
+    }
+
+    static constexpr std::size_t max_number_of_segments = 48;
+
+    std::array<std::atomic<value_type*>, max_number_of_segments> segments_{};
+    std::atomic_size_t size_ = 0;
+};
+
+} // namespace rsce
+} // namespace arba
@@ -0,0 +1,203 @@
+#pragma once
+
+#include "counting_loader_executor.hpp"
+#include "resource_store.hpp"
+
+#include <cstddef>
+#include <filesystem>
+#include <memory>
+#include <new>
+#include <span>
+#include <tuple>
+#include <type_traits>
+
+inline namespace arba
+{
+namespace rsce
+{
+
+// Resource manager of resource types known at compile time. Its resource stores are members, so that the store of a
+// resource type is resolved at compile time, without type index nor lock. It is the resource manager given to the
+// resources it loads (see load_resource_from_file()), which must accept it, e.g. with a template parameter.
+template <class... resource_types>
+class static_resource_manager
+{
+public:
+    // True if resource is one of the resource types of this manager.
+    template <class resource>
+    static constexpr bool manages = ((std::is_same_v<resource, resource_types> ? 1 : 0) + ... + 0) == 1;
+
+    static_assert((manages<resource_types> && ...), "Resource types must be distinct.");
+
+    static_resource_manager() = default;
+    // The loader threads, used by asynchronous loadings, are started on the first asynchronous loading. At least one
+    // loader thread is started, even if number_of_loader_threads is 0.
+    explicit static_resource_manager(std::size_t number_of_loader_threads)
+        : counting_executor_(number_of_loader_threads)
+    {
+    }
+    // The asynchronous loadings are submitted to executor, which may be shared with other managers.
+    explicit static_resource_manager(std::shared_ptr<loader_executor> executor)
+        : counting_executor_(std::move(executor))
+    {
+    }
+    static_resource_manager(const static_resource_manager&) = delete;
+    static_resource_manager& operator=(const static_resource_manager&) = delete;
+    // Waits for the asynchronous loadings submitted by this manager (see counting_loader_executor).
+    ~static_resource_manager() = default;
+
+    template <class resource>
+    inline std::shared_ptr<resource> get_shared(const std::filesystem::path& rsc_path)
+    {
+        return store<resource>().get_shared(rsc_path, *this);
+    }
+
+    // A cache hit constructs no path (see default_resource_store::find()).
+    template <class resource, concepts::path_string string_type>
+    inline std::shared_ptr<resource> get_shared(const string_type& rsc_path)
+    {
+        return store<resource>().get_shared(rsc_path, *this);
+    }
+
+    // A cache hit does not hash rsc_path (see hashed_path).
+    template <class resource>
+    inline std::shared_ptr<resource> get_shared(hashed_path_view rsc_path)
+    {
+        return store<resource>().get_shared(rsc_path, *this);
+    }
+
+    template <class resource>
+    inline std::shared_ptr<resource> get_shared(resource_id<resource> rsc_id)
+    {
+        return store<resource>().get_shared(rsc_id, *this);
+    }
+
+    template <class resource>
+    inline std::shared_ptr<resource> get_shared(const std::filesystem::path& rsc_path, std::nothrow_t)
+    {
+        return store<resource>().get_shared(rsc_path, *this, std::nothrow);
+    }
+
+#ifdef ARBA_RSCE_HAS_EXPECTED
+    // A failure is returned instead of thrown (see default_resource_store::try_get_shared()).
+    template <class resource>
+    inline std::expected<std::shared_ptr<resource>, load_error> try_get_shared(const std::filesystem::path& rsc_path)
+    {
+        return store<resource>().try_get_shared(rsc_path, *this);
+    }
+#endif
+
+    template <class resource>
+    inline resource_id<resource> intern(const std::filesystem::path& rsc_path)
+    {
+        return store<resource>().intern(rsc_path);
+    }
+
+    template <class resource>
+    inline resource_handle<resource> get_handle(const std::filesystem::path& rsc_path)
+    {
+        return store<resource>().get_handle(rsc_path, *this);
+    }
+
+    template <class resource>
+    inline resource& get(const std::filesystem::path& rsc_path)
+    {
+        return *get_shared<resource>(rsc_path);
+    }
+
+    template <class resource, concepts::path_string string_type>
+    inline resource& get(const string_type& rsc_path)
+    {
+        return *get_shared<resource>(rsc_path);
+    }
+
+    template <class resource>
+    inline resource& get(hashed_path_view rsc_path)
+    {
+        return *get_shared<resource>(rsc_path);
+    }
+
+    template <class resource>
+    inline bool insert(const std::filesystem::path& rsc_path, std::shared_ptr<resource> rsc_sptr)
+    {
+        return store<resource>().insert(rsc_path, std::move(rsc_sptr));
+    }
+
+    template <class resource>
+    inline void set(const std::filesystem::path& rsc_path, std::shared_ptr<resource>&& rsc_sptr)
+    {
+        store<resource>().set(rsc_path, std::move(rsc_sptr));
+    }
+
+    template <class resource>
+    inline std::shared_ptr<resource> load(const std::filesystem::path& rsc_path, load_mode mode = load_mode::force)
+    {
+        return store<resource>().load(rsc_path, *this, mode);
+    }
+
+    template <class resource>
+    inline resource_future<resource> get_shared_async(const std::filesystem::path& rsc_path)
+    {
+        return store<resource>().get_shared_async(rsc_path, *this, counting_executor_);
+    }
+
+    template <class resource>
+    inline resource_future<resource> load_async(const std::filesystem::path& rsc_path,
+                                                load_mode mode = load_mode::force)
+    {
+        return store<resource>().load_async(rsc_path, *this, counting_executor_, mode);
+    }
+
+    // Loads in parallel the resources which are not stored yet, then inserts them in the store.
+    template <class resource>
+    inline void preload(std::span<const std::filesystem::path> rsc_paths)
+    {
+        preload_async<resource>(rsc_paths).wait();
+    }
+
+    template <class resource>
+    inline resource_preloading preload_async(std::span<const std::filesystem::path> rsc_paths)
+    {
+        return store<resource>().preload_async(rsc_paths, *this, counting_executor_);
+    }
+
+    template <class resource>
+    inline void remove(const std::filesystem::path& rsc_path)
+    {
+        store<resource>().remove(rsc_path);
+    }
+
+    // Forgets the canonical paths cached by the resource stores, to be called when files or links were moved.
+    inline void invalidate_canonical_paths()
+    {
+        std::apply([](auto&... rsc_stores) { (rsc_stores.invalidate_canonical_paths(), ...); }, resource_stores_);
+    }
+
+    // Forgets the failures remembered by the resource stores, to be called when files were added or fixed.
+    inline void forget_failures()
+    {
+        std::apply([](auto&... rsc_stores) { (rsc_stores.forget_failures(), ...); }, resource_stores_);
+    }
+
+    template <class resource>
+    inline std::size_t number_of_resources()
+    {
+        return store<resource>().size();
+    }
+
+    template <class resource>
+    inline resource_store<resource>& store()
+    {
+        static_assert(manages<resource>, "The resource type is not managed by this manager.");
+        return std::get<resource_store<resource>>(resource_stores_);
+    }
+
+private:
+    std::tuple<resource_store<resource_types>...> resource_stores_;
+    // Declared after the resource stores, so that the pending loadings are waited for and an owned loader thread pool
+    // is joined before the stores are destroyed.
+    counting_loader_executor counting_executor_;
+};
+
+} // namespace rsce
+} // namespace arba
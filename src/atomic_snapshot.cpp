@@ -0,0 +1,66 @@
+#include <arba/rsce/atomic_snapshot.hpp>
+
+#include <algorithm>
+#include <array>
+
+inline namespace arba
+{
+namespace rsce
+{
+
+namespace
+{
+struct alignas(64) hazard_pointer_slot
+{
+    std::atomic<const void*> pointer = nullptr;
+    std::atomic_bool is_owned = false;
+};
+
+std::array<hazard_pointer_slot, hazard_pointer_slots::max_number_of_slots> hazard_pointer_slot_array;
+
+class hazard_pointer_slot_owner
+{
+public:
+    hazard_pointer_slot_owner()
+    {
+        for (hazard_pointer_slot& slot : hazard_pointer_slot_array)
+        {
+            bool is_owned = false;
+            if (!slot.is_owned.load(std::memory_order_relaxed)
+                && slot.is_owned.compare_exchange_strong(is_owned, true, std::memory_order_acquire))
+            {
+                slot_ = &slot;
+                break;
+            }
+        }
+    }
+
+    ~hazard_pointer_slot_owner()
+    {
+        if (slot_)
+            slot_->is_owned.store(false, std::memory_order_release);
+    }
+
+    hazard_pointer_slot* slot() const noexcept { return slot_; }
+
+private:
+    hazard_pointer_slot* slot_ = nullptr;
+};
+} // namespace
+
+std::atomic<const void*>* hazard_pointer_slots::thread_slot() noexcept
+{
+    thread_local hazard_pointer_slot_owner slot_owner;
+    hazard_pointer_slot* slot = slot_owner.slot();
+    return slot ? &slot->pointer : nullptr;
+}
+
+bool hazard_pointer_slots::is_protected(const void* ptr) noexcept
+{
+    return std::ranges::any_of(hazard_pointer_slot_array, [ptr](const hazard_pointer_slot& slot) {
+        return slot.pointer.load(std::memory_order_seq_cst) == ptr;
+    });
+}
+
+} // namespace rsce
+} // namespace arba
@@ -0,0 +1,51 @@
+#include <arba/rsce/counting_loader_executor.hpp>
+
+#include <algorithm>
+
+inline namespace arba
+{
+namespace rsce
+{
+
+counting_loader_executor::counting_loader_executor(std::size_t number_of_loader_threads)
+    : number_of_loader_threads_(std::max<std::size_t>(number_of_loader_threads, 1))
+{
+}
+
+counting_loader_executor::counting_loader_executor(std::shared_ptr<loader_executor> executor)
+    : number_of_loader_threads_(0), loader_executor_sptr_(std::move(executor))
+{
+}
+
+counting_loader_executor::~counting_loader_executor()
+{
+    std::unique_lock lock(pending_loadings_mutex_);
+    pending_loadings_condition_.wait(lock, [this]() { return number_of_pending_loadings_ == 0; });
+}
+
+void counting_loader_executor::submit(std::function<void()> task)
+{
+    {
+        std::lock_guard lock(pending_loadings_mutex_);
+        ++number_of_pending_loadings_;
+    }
+    executor().submit([this, task = std::move(task)]() {
+        task();
+        // Notified under the lock, so that this executor is not destroyed before the notification.
+        std::lock_guard lock(pending_loadings_mutex_);
+        if (--number_of_pending_loadings_ == 0)
+            pending_loadings_condition_.notify_all();
+    });
+}
+
+loader_executor& counting_loader_executor::executor()
+{
+    std::call_once(loader_executor_flag_, [this]() {
+        if (!loader_executor_sptr_)
+            loader_executor_sptr_ = std::make_shared<loader_thread_pool>(number_of_loader_threads_);
+    });
+    return *loader_executor_sptr_;
+}
+
+} // namespace rsce
+} // namespace arba
@@ -0,0 +1,40 @@
+#include <arba/rsce/load_error.hpp>
+
+#include <string>
+
+inline namespace arba
+{
+namespace rsce
+{
+
+namespace
+{
+class load_error_category : public std::error_category
+{
+public:
+    const char* name() const noexcept override { return "rsce"; }
+
+    std::string message(int condition) const override
+    {
+        switch (static_cast<load_errc>(condition))
+        {
+        case load_errc::resource_not_loaded:
+            return "resource not loaded";
+        case load_errc::exception_thrown:
+            return "exception thrown while loading resource";
+        case load_errc::pack_path_not_supported:
+            return "operation not supported on a resource pack path";
+        }
+        return "unknown resource loading error";
+    }
+};
+} // namespace
+
+const std::error_category& load_category() noexcept
+{
+    static const load_error_category category;
+    return category;
+}
+
+} // namespace rsce
+} // namespace arba
@@ -0,0 +1,24 @@
+#include <arba/rsce/loader_executor.hpp>
+
+inline namespace arba
+{
+namespace rsce
+{
+
+namespace
+{
+thread_local loader_executor* current_thread_executor_ptr = nullptr;
+} // namespace
+
+loader_executor* loader_executor::current_thread_executor() noexcept
+{
+    return current_thread_executor_ptr;
+}
+
+void loader_executor::set_current_thread_executor_(loader_executor* executor) noexcept
+{
+    current_thread_executor_ptr = executor;
+}
+
+} // namespace rsce
+} // namespace arba
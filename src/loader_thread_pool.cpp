@@ -0,0 +1,130 @@
+#include <arba/rsce/loader_thread_pool.hpp>
+
+#include <algorithm>
+
+inline namespace arba
+{
+namespace rsce
+{
+
+namespace
+{
+// Index of the calling thread in its pool, meaningful only if loader_executor::current_thread_executor() is this pool.
+thread_local std::size_t current_thread_index = 0;
+} // namespace
+
+std::size_t loader_thread_pool::default_number_of_threads()
+{
+    return std::max(std::thread::hardware_concurrency(), 1u);
+}
+
+loader_thread_pool::loader_thread_pool(std::size_t number_of_threads)
+    : thread_queues_(std::make_unique<task_queue[]>(std::max<std::size_t>(number_of_threads, 1)))
+{
+    number_of_threads = std::max<std::size_t>(number_of_threads, 1);
+    threads_.reserve(number_of_threads);
+    for (std::size_t i = 0; i < number_of_threads; ++i)
+        threads_.emplace_back([this, i]() { run_(i); });
+}
+
+loader_thread_pool::~loader_thread_pool()
+{
+    {
+        std::lock_guard lock(sleep_mutex_);
+        stopping_ = true;
+    }
+    sleep_condition_.notify_all();
+    threads_.clear();
+}
+
+void loader_thread_pool::submit(std::function<void()> task)
+{
+    task_queue& queue = current_thread_executor() == this ? thread_queues_[current_thread_index] : shared_queue_;
+    {
+        std::lock_guard lock(queue.mutex);
+        queue.tasks.push_back(std::move(task));
+    }
+    number_of_pending_tasks_.fetch_add(1, std::memory_order_release);
+    {
+        // Synchronizes with a thread checking number_of_pending_tasks_ before going to sleep.
+        std::lock_guard lock(sleep_mutex_);
+    }
+    sleep_condition_.notify_one();
+}
+
+bool loader_thread_pool::try_run_pending_task()
+{
+    std::function<void()> task;
+    if (!try_pop_task_(task))
+        return false;
+    task();
+    return true;
+}
+
+void loader_thread_pool::run_(std::size_t thread_index)
+{
+    set_current_thread_executor_(this);
+    current_thread_index = thread_index;
+    for (;;)
+    {
+        if (try_run_pending_task())
+            continue;
+
+        std::unique_lock lock(sleep_mutex_);
+        sleep_condition_.wait(lock, [this]() {
+            return stopping_ || number_of_pending_tasks_.load(std::memory_order_acquire) > 0;
+        });
+        if (stopping_ && number_of_pending_tasks_.load(std::memory_order_acquire) == 0)
+            break;
+    }
+    set_current_thread_executor_(nullptr);
+}
+
+bool loader_thread_pool::try_pop_task_(std::function<void()>& task)
+{
+    if (number_of_pending_tasks_.load(std::memory_order_acquire) == 0)
+        return false;
+
+    const std::size_t number_of_queues = threads_.size();
+    bool found = false;
+    if (current_thread_executor() == this)
+    {
+        const std::size_t thread_index = current_thread_index;
+        found = try_pop_back_(thread_queues_[thread_index], task) || try_pop_front_(shared_queue_, task);
+        for (std::size_t i = 1; !found && i < number_of_queues; ++i)
+            found = try_pop_front_(thread_queues_[(thread_index + i) % number_of_queues], task);
+    }
+    else
+    {
+        found = try_pop_front_(shared_queue_, task);
+        for (std::size_t i = 0; !found && i < number_of_queues; ++i)
+            found = try_pop_front_(thread_queues_[i], task);
+    }
+
+    if (found)
+        number_of_pending_tasks_.fetch_sub(1, std::memory_order_relaxed);
+    return found;
+}
+
+bool loader_thread_pool::try_pop_front_(task_queue& queue, std::function<void()>& task)
+{
+    std::lock_guard lock(queue.mutex);
+    if (queue.tasks.empty())
+        return false;
+    task = std::move(queue.tasks.front());
+    queue.tasks.pop_front();
+    return true;
+}
+
+bool loader_thread_pool::try_pop_back_(task_queue& queue, std::function<void()>& task)
+{
+    std::lock_guard lock(queue.mutex);
+    if (queue.tasks.empty())
+        return false;
+    task = std::move(queue.tasks.back());
+    queue.tasks.pop_back();
+    return true;
+}
+
+} // namespace rsce
+} // namespace arba
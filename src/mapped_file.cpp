@@ -0,0 +1,148 @@
+#include <arba/rsce/mapped_file.hpp>
+
+#include <utility>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#endif
+
+inline namespace arba
+{
+namespace rsce
+{
+
+mapped_file::mapped_file(const std::filesystem::path& fpath)
+{
+    std::error_code error_code;
+    *this = mapped_file(fpath, error_code);
+    if (error_code) [[unlikely]]
+        throw std::filesystem::filesystem_error("cannot map file", fpath, error_code);
+}
+
+#ifdef _WIN32
+
+mapped_file::mapped_file(const std::filesystem::path& fpath, std::error_code& error_code) noexcept
+{
+    error_code.clear();
+    HANDLE file_handle = ::CreateFileW(fpath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                                      FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file_handle == INVALID_HANDLE_VALUE) [[unlikely]]
+    {
+        error_code.assign(static_cast<int>(::GetLastError()), std::system_category());
+        return;
+    }
+
+    LARGE_INTEGER file_size;
+    if (!::GetFileSizeEx(file_handle, &file_size)) [[unlikely]]
+    {
+        error_code.assign(static_cast<int>(::GetLastError()), std::system_category());
+        ::CloseHandle(file_handle);
+        return;
+    }
+    if (file_size.QuadPart == 0)
+    {
+        ::CloseHandle(file_handle);
+        return;
+    }
+
+    // The view keeps the mapping, which keeps the file, open: both handles are closed at once.
+    HANDLE mapping_handle = ::CreateFileMappingW(file_handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping_handle)
+    {
+        if (void* view = ::MapViewOfFile(mapping_handle, FILE_MAP_READ, 0, 0, 0))
+        {
+            data_ = static_cast<const std::byte*>(view);
+            size_ = static_cast<std::size_t>(file_size.QuadPart);
+        }
+    }
+    if (!data_) [[unlikely]]
+        error_code.assign(static_cast<int>(::GetLastError()), std::system_category());
+    if (mapping_handle)
+        ::CloseHandle(mapping_handle);
+    ::CloseHandle(file_handle);
+}
+
+void mapped_file::unmap_() noexcept
+{
+    if (data_)
+        ::UnmapViewOfFile(data_);
+}
+
+#else
+
+mapped_file::mapped_file(const std::filesystem::path& fpath, std::error_code& error_code) noexcept
+{
+    error_code.clear();
+    int file_descriptor = ::open(fpath.c_str(), O_RDONLY | O_CLOEXEC);
+    if (file_descriptor < 0) [[unlikely]]
+    {
+        error_code.assign(errno, std::generic_category());
+        return;
+    }
+
+    struct stat file_status;
+    if (::fstat(file_descriptor, &file_status) != 0) [[unlikely]]
+        error_code.assign(errno, std::generic_category());
+    else if (!S_ISREG(file_status.st_mode)) [[unlikely]]
+        error_code = std::make_error_code(std::errc::invalid_argument);
+    else if (file_status.st_size > 0)
+    {
+        // The mapping keeps the file open: the file descriptor is closed at once.
+        const std::size_t file_size = static_cast<std::size_t>(file_status.st_size);
+        void* address = ::mmap(nullptr, file_size, PROT_READ, MAP_PRIVATE, file_descriptor, 0);
+        if (address == MAP_FAILED) [[unlikely]]
+            error_code.assign(errno, std::generic_category());
+        else
+        {
+            ::posix_madvise(address, file_size, POSIX_MADV_SEQUENTIAL);
+            data_ = static_cast<const std::byte*>(address);
+            size_ = file_size;
+        }
+    }
+    ::close(file_descriptor);
+}
+
+void mapped_file::unmap_() noexcept
+{
+    if (data_)
+        ::munmap(const_cast<std::byte*>(data_), size_);
+}
+
+#endif
+
+mapped_file::mapped_file(mapped_file&& other) noexcept
+    : data_(std::exchange(other.data_, nullptr)), size_(std::exchange(other.size_, 0))
+{
+}
+
+mapped_file& mapped_file::operator=(mapped_file&& other) noexcept
+{
+    if (this != &other)
+    {
+        unmap_();
+        data_ = std::exchange(other.data_, nullptr);
+        size_ = std::exchange(other.size_, 0);
+    }
+    return *this;
+}
+
+mapped_file::~mapped_file()
+{
+    unmap_();
+}
+
+} // namespace rsce
+} // namespace arba
@@ -0,0 +1,50 @@
+#include <arba/rsce/memory_stream.hpp>
+
+inline namespace arba
+{
+namespace rsce
+{
+
+memory_streambuf::memory_streambuf(std::span<const std::byte> bytes)
+{
+    // The get area is never written: the streambuf interface only takes non-const pointers.
+    char* begin = const_cast<char*>(reinterpret_cast<const char*>(bytes.data()));
+    setg(begin, begin, begin + bytes.size());
+}
+
+memory_streambuf::pos_type memory_streambuf::seekoff(off_type offset, std::ios_base::seekdir direction,
+                                                     std::ios_base::openmode mode)
+{
+    if (!(mode & std::ios_base::in)) [[unlikely]]
+        return pos_type(off_type(-1));
+
+    off_type origin = 0;
+    if (direction == std::ios_base::cur)
+        origin = gptr() - eback();
+    else if (direction == std::ios_base::end)
+        origin = egptr() - eback();
+    const off_type position = origin + offset;
+    if (position < 0 || position > egptr() - eback()) [[unlikely]]
+        return pos_type(off_type(-1));
+    setg(eback(), eback() + position, egptr());
+    return pos_type(position);
+}
+
+memory_streambuf::pos_type memory_streambuf::seekpos(pos_type position, std::ios_base::openmode mode)
+{
+    return seekoff(off_type(position), std::ios_base::beg, mode);
+}
+
+std::streamsize memory_streambuf::showmanyc()
+{
+    const std::streamsize number_of_chars = egptr() - gptr();
+    return number_of_chars > 0 ? number_of_chars : -1;
+}
+
+memory_istream::memory_istream(std::span<const std::byte> bytes) : std::istream(nullptr), streambuf_(bytes)
+{
+    rdbuf(&streambuf_);
+}
+
+} // namespace rsce
+} // namespace arba
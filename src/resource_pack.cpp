@@ -0,0 +1,452 @@
+#include <arba/rsce/resource_pack.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <exception>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <system_error>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+
+inline namespace arba
+{
+namespace rsce
+{
+
+namespace
+{
+// The integers of a pack are little-endian, whatever the endianness of the target.
+template <class integer_type>
+integer_type load_integer(const std::byte* bytes) noexcept
+{
+    integer_type value = 0;
+    for (std::size_t i = 0; i < sizeof(integer_type); ++i)
+        value |= static_cast<integer_type>(std::to_integer<integer_type>(bytes[i]) << (8 * i));
+    return value;
+}
+
+template <class integer_type>
+void store_integer(std::byte* bytes, integer_type value) noexcept
+{
+    for (std::size_t i = 0; i < sizeof(integer_type); ++i)
+        bytes[i] = static_cast<std::byte>(value >> (8 * i));
+}
+
+std::size_t align_offset(std::size_t offset, std::size_t alignment) noexcept
+{
+    return (offset + alignment - 1) & ~(alignment - 1);
+}
+
+[[noreturn]] void throw_invalid_pack(const std::filesystem::path& fpath, const char* reason)
+{
+    throw std::filesystem::filesystem_error(std::string("invalid resource pack: ") + reason, fpath,
+                                            std::make_error_code(std::errc::invalid_argument));
+}
+} // namespace
+
+resource_pack::resource_pack(const std::filesystem::path& fpath) : path_(fpath), file_(fpath)
+{
+    const std::byte* data = file_.data();
+    const std::size_t file_size = file_.size();
+    if (file_size < header_size || std::string_view(reinterpret_cast<const char*>(data), magic.size()) != magic)
+        [[unlikely]]
+        throw_invalid_pack(fpath, "bad magic");
+    if (load_integer<std::uint32_t>(data + 8) != version) [[unlikely]]
+        throw_invalid_pack(fpath, "unsupported version");
+    const std::uint32_t blob_alignment = load_integer<std::uint32_t>(data + 12);
+    if (!std::has_single_bit(blob_alignment)) [[unlikely]]
+        throw_invalid_pack(fpath, "bad blob alignment");
+
+    // The sizes are checked one after the other, so that no sum overflows.
+    const std::uint64_t number_of_entries = load_integer<std::uint64_t>(data + 16);
+    const std::uint64_t paths_size = load_integer<std::uint64_t>(data + 24);
+    std::size_t remaining_size = file_size - header_size;
+    if (number_of_entries > remaining_size / index_entry_size) [[unlikely]]
+        throw_invalid_pack(fpath, "truncated index");
+    remaining_size -= number_of_entries * index_entry_size;
+    if (paths_size > remaining_size) [[unlikely]]
+        throw_invalid_pack(fpath, "truncated path table");
+    number_of_entries_ = number_of_entries;
+    paths_ = data + header_size + number_of_entries * index_entry_size;
+
+    // Checked once, so that lookups trust the index.
+    std::string_view previous_path;
+    for (std::size_t index = 0; index < number_of_entries_; ++index)
+    {
+        const std::byte* entry = index_entry_(index);
+        const std::uint64_t offset = load_integer<std::uint64_t>(entry);
+        const std::uint64_t size = load_integer<std::uint64_t>(entry + 8);
+        const std::uint32_t path_offset = load_integer<std::uint32_t>(entry + 16);
+        const std::uint32_t path_size = load_integer<std::uint32_t>(entry + 20);
+        if (offset > file_size || size > file_size - offset) [[unlikely]]
+            throw_invalid_pack(fpath, "entry out of the file");
+        if (offset % blob_alignment != 0) [[unlikely]]
+            throw_invalid_pack(fpath, "misaligned entry");
+        if (path_offset > paths_size || path_size > paths_size - path_offset) [[unlikely]]
+            throw_invalid_pack(fpath, "entry path out of the path table");
+        if (load_integer<std::uint32_t>(entry + 24) != 0 || load_integer<std::uint32_t>(entry + 28) != 0) [[unlikely]]
+            throw_invalid_pack(fpath, "unsupported entry flags");
+        const std::string_view path = entry_path(index);
+        if (index > 0 && !(previous_path < path)) [[unlikely]]
+            throw_invalid_pack(fpath, "unsorted index");
+        previous_path = path;
+    }
+}
+
+std::optional<std::span<const std::byte>> resource_pack::find(std::string_view entry_path) const noexcept
+{
+    std::size_t first = 0;
+    std::size_t count = number_of_entries_;
+    while (count > 0)
+    {
+        const std::size_t step = count / 2;
+        if (this->entry_path(first + step) < entry_path)
+        {
+            first += step + 1;
+            count -= step + 1;
+        }
+        else
+            count = step;
+    }
+    if (first < number_of_entries_ && this->entry_path(first) == entry_path)
+        return entry_bytes(first);
+    return std::nullopt;
+}
+
+std::span<const std::byte> resource_pack::at(std::string_view entry_path) const
+{
+    if (std::optional<std::span<const std::byte>> bytes = find(entry_path)) [[likely]]
+        return *bytes;
+    throw std::filesystem::filesystem_error("no such entry in resource pack", path_, std::filesystem::path(entry_path),
+                                            std::make_error_code(std::errc::no_such_file_or_directory));
+}
+
+std::string_view resource_pack::entry_path(std::size_t index) const noexcept
+{
+    const std::byte* entry = index_entry_(index);
+    return std::string_view(reinterpret_cast<const char*>(paths_ + load_integer<std::uint32_t>(entry + 16)),
+                            load_integer<std::uint32_t>(entry + 20));
+}
+
+std::span<const std::byte> resource_pack::entry_bytes(std::size_t index) const noexcept
+{
+    const std::byte* entry = index_entry_(index);
+    return file_.bytes().subspan(load_integer<std::uint64_t>(entry), load_integer<std::uint64_t>(entry + 8));
+}
+
+bool resource_pack::is_valid_entry_path(std::string_view entry_path) noexcept
+{
+    if (entry_path.empty() || entry_path.size() > std::numeric_limits<std::uint32_t>::max())
+        return false;
+    for (std::size_t first = 0; first <= entry_path.size();)
+    {
+        std::size_t last = entry_path.find('/', first);
+        if (last == std::string_view::npos)
+            last = entry_path.size();
+        const std::string_view component = entry_path.substr(first, last - first);
+        if (component.empty() || component == "." || component == ".."
+            || component.find('\\') != std::string_view::npos)
+            return false;
+        first = last + 1;
+    }
+    return true;
+}
+
+const std::byte* resource_pack::index_entry_(std::size_t index) const noexcept
+{
+    return file_.data() + header_size + index * index_entry_size;
+}
+
+resource_pack_builder::resource_pack_builder(std::size_t blob_alignment)
+    : blob_alignment_(blob_alignment), number_of_threads_(std::max(std::thread::hardware_concurrency(), 1u))
+{
+    if (!std::has_single_bit(blob_alignment) || blob_alignment > std::numeric_limits<std::uint32_t>::max())
+        throw std::invalid_argument("The blob alignment must be a power of two.");
+}
+
+void resource_pack_builder::add(std::string entry_path, std::vector<std::byte> bytes)
+{
+    if (!resource_pack::is_valid_entry_path(entry_path)) [[unlikely]]
+        throw std::invalid_argument("Invalid resource pack entry path: '" + entry_path + "'.");
+    entries_.insert_or_assign(std::move(entry_path), std::move(bytes));
+}
+
+void resource_pack_builder::add_file(std::string entry_path, std::filesystem::path fpath)
+{
+    if (!resource_pack::is_valid_entry_path(entry_path)) [[unlikely]]
+        throw std::invalid_argument("Invalid resource pack entry path: '" + entry_path + "'.");
+    entries_.insert_or_assign(std::move(entry_path), std::move(fpath));
+}
+
+std::size_t resource_pack_builder::add_directory(const std::filesystem::path& dpath, std::string_view entry_prefix,
+                                                 const std::filesystem::path& excluded_pack_fpath)
+{
+    std::filesystem::path excluded_temp_fpath = excluded_pack_fpath;
+    excluded_temp_fpath += ".tmp";
+    // The file names are compared first, so that only the candidates are checked on the file system.
+    auto is_excluded = [&](const std::filesystem::path& fpath) {
+        std::error_code error;
+        if (excluded_pack_fpath.empty())
+            return false;
+        if (fpath.filename() == excluded_pack_fpath.filename())
+            return std::filesystem::equivalent(fpath, excluded_pack_fpath, error);
+        if (fpath.filename() == excluded_temp_fpath.filename())
+            return std::filesystem::equivalent(fpath, excluded_temp_fpath, error);
+        return false;
+    };
+
+    std::size_t number_of_files = 0;
+    for (const std::filesystem::directory_entry& entry : std::filesystem::recursive_directory_iterator(dpath))
+    {
+        if (!entry.is_regular_file() || is_excluded(entry.path()))
+            continue;
+        const std::u8string relative_path = entry.path().lexically_relative(dpath).generic_u8string();
+        std::string entry_path(entry_prefix);
+        if (!entry_path.empty())
+            entry_path += '/';
+        entry_path.append(reinterpret_cast<const char*>(relative_path.data()), relative_path.size());
+        add_file(std::move(entry_path), entry.path());
+        ++number_of_files;
+    }
+    return number_of_files;
+}
+
+namespace
+{
+// Contents of an entry, mapped if they are read from a file.
+class entry_contents
+{
+public:
+    explicit entry_contents(const std::variant<std::vector<std::byte>, std::filesystem::path>& source)
+    {
+        if (const std::vector<std::byte>* bytes = std::get_if<std::vector<std::byte>>(&source))
+            bytes_ = *bytes;
+        else
+        {
+            file_ = mapped_file(std::get<std::filesystem::path>(source));
+            bytes_ = file_.bytes();
+        }
+    }
+
+    inline std::span<const std::byte> bytes() const noexcept { return bytes_; }
+
+private:
+    mapped_file file_;
+    std::span<const std::byte> bytes_;
+};
+
+std::uint64_t content_hash(std::span<const std::byte> bytes) noexcept
+{
+    // Only used to find candidate duplicates, which are then compared byte by byte.
+    constexpr std::uint64_t multiplier = 0x9e3779b97f4a7c15ull;
+    std::uint64_t hash = bytes.size() * multiplier;
+    std::size_t index = 0;
+    for (; index + 8 <= bytes.size(); index += 8)
+        hash = (std::rotl(hash, 23) ^ load_integer<std::uint64_t>(bytes.data() + index)) * multiplier;
+    for (; index < bytes.size(); ++index)
+        hash = (std::rotl(hash, 23) ^ std::to_integer<std::uint64_t>(bytes[index])) * multiplier;
+    return hash ^ (hash >> 29);
+}
+
+// Calls function(index) for each index in [0, count), on number_of_threads threads. The first exception thrown is
+// rethrown, once the threads are joined.
+template <class function_type>
+void parallel_for(std::size_t count, std::size_t number_of_threads, function_type&& function)
+{
+    number_of_threads = std::min(number_of_threads, count);
+    if (number_of_threads <= 1)
+    {
+        for (std::size_t index = 0; index < count; ++index)
+            function(index);
+        return;
+    }
+
+    std::atomic_size_t next_index = 0;
+    std::exception_ptr exception;
+    std::mutex exception_mutex;
+    {
+        std::vector<std::jthread> threads;
+        threads.reserve(number_of_threads);
+        for (std::size_t i = 0; i < number_of_threads; ++i)
+        {
+            threads.emplace_back([&]() {
+                try
+                {
+                    for (std::size_t index = next_index++; index < count; index = next_index++)
+                        function(index);
+                }
+                catch (...)
+                {
+                    next_index = count;
+                    std::lock_guard lock(exception_mutex);
+                    if (!exception)
+                        exception = std::current_exception();
+                }
+            });
+        }
+    }
+    if (exception) [[unlikely]]
+        std::rethrow_exception(exception);
+}
+} // namespace
+
+resource_pack_builder::write_summary resource_pack_builder::write(const std::filesystem::path& fpath) const
+{
+    // The entries are sorted by path, and each blob is written at the place of the first entry having its contents.
+    std::vector<const std::pair<const std::string, entry_source>*> entries;
+    entries.reserve(entries_.size());
+    std::string paths;
+    for (const auto& entry : entries_)
+    {
+        entries.push_back(&entry);
+        paths += entry.first;
+    }
+    if (paths.size() > std::numeric_limits<std::uint32_t>::max()) [[unlikely]]
+        throw std::length_error("The paths of a resource pack must fit in 4 GiB.");
+
+    // The files are read and hashed in parallel. Without deduplication, only their sizes are needed here.
+    std::vector<std::uint64_t> sizes(entries.size());
+    std::vector<std::uint64_t> hashes(deduplication_ ? entries.size() : 0);
+    parallel_for(entries.size(), number_of_threads_, [&](std::size_t index) {
+        const entry_source& source = entries[index]->second;
+        if (deduplication_)
+        {
+            const entry_contents contents(source);
+            sizes[index] = contents.bytes().size();
+            hashes[index] = content_hash(contents.bytes());
+        }
+        else if (const std::filesystem::path* file_path = std::get_if<std::filesystem::path>(&source))
+            sizes[index] = std::filesystem::file_size(*file_path);
+        else
+            sizes[index] = std::get<std::vector<std::byte>>(source).size();
+    });
+
+    // The entry indexes of the blobs, and the blob index of each entry. Entries are only compared byte by byte when
+    // their sizes and hashes are equal, and each one is then mapped once.
+    std::vector<std::size_t> blob_entries;
+    std::vector<std::size_t> entry_blobs(entries.size());
+    std::unordered_multimap<std::uint64_t, std::size_t> blobs_by_hash;
+    std::vector<std::unique_ptr<const entry_contents>> compared_contents(deduplication_ ? entries.size() : 0);
+    auto contents_of = [&](std::size_t index) -> const entry_contents& {
+        if (!compared_contents[index])
+            compared_contents[index] = std::make_unique<const entry_contents>(entries[index]->second);
+        return *compared_contents[index];
+    };
+    for (std::size_t index = 0; index < entries.size(); ++index)
+    {
+        std::size_t blob = blob_entries.size();
+        if (deduplication_)
+        {
+            auto [first, last] = blobs_by_hash.equal_range(hashes[index]);
+            for (; first != last; ++first)
+            {
+                const std::size_t blob_entry = blob_entries[first->second];
+                if (sizes[blob_entry] == sizes[index]
+                    && std::ranges::equal(contents_of(blob_entry).bytes(), contents_of(index).bytes()))
+                {
+                    blob = first->second;
+                    break;
+                }
+            }
+            if (blob == blob_entries.size())
+                blobs_by_hash.emplace(hashes[index], blob);
+        }
+        if (blob == blob_entries.size())
+            blob_entries.push_back(index);
+        entry_blobs[index] = blob;
+    }
+    // Only the contents of the blobs are still needed.
+    for (std::size_t index = 0; index < compared_contents.size(); ++index)
+    {
+        if (compared_contents[index] && blob_entries[entry_blobs[index]] != index)
+            compared_contents[index].reset();
+    }
+
+    std::vector<std::byte> head(resource_pack::header_size + entries.size() * resource_pack::index_entry_size);
+    std::copy_n(reinterpret_cast<const std::byte*>(resource_pack::magic.data()), resource_pack::magic.size(),
+                head.data());
+    store_integer<std::uint32_t>(head.data() + 8, resource_pack::version);
+    store_integer<std::uint32_t>(head.data() + 12, static_cast<std::uint32_t>(blob_alignment_));
+    store_integer<std::uint64_t>(head.data() + 16, entries.size());
+    store_integer<std::uint64_t>(head.data() + 24, paths.size());
+    std::vector<std::uint64_t> blob_offsets(blob_entries.size());
+    std::uint64_t offset = align_offset(head.size() + paths.size(), blob_alignment_);
+    for (std::size_t blob = 0; blob < blob_entries.size(); ++blob)
+    {
+        blob_offsets[blob] = offset;
+        offset = align_offset(offset + sizes[blob_entries[blob]], blob_alignment_);
+    }
+    std::uint32_t path_offset = 0;
+    std::byte* index_entry = head.data() + resource_pack::header_size;
+    for (std::size_t index = 0; index < entries.size(); ++index)
+    {
+        const std::string& entry_path = entries[index]->first;
+        store_integer<std::uint64_t>(index_entry, blob_offsets[entry_blobs[index]]);
+        store_integer<std::uint64_t>(index_entry + 8, sizes[index]);
+        store_integer<std::uint32_t>(index_entry + 16, path_offset);
+        store_integer<std::uint32_t>(index_entry + 20, static_cast<std::uint32_t>(entry_path.size()));
+        path_offset += static_cast<std::uint32_t>(entry_path.size());
+        index_entry += resource_pack::index_entry_size;
+    }
+
+    // The pack is written in a sibling temporary file, renamed once complete: a failed write leaves no partial pack,
+    // and a previous pack is replaced at once.
+    std::filesystem::path temp_fpath = fpath;
+    temp_fpath += ".tmp";
+    std::uint64_t written_size = head.size() + paths.size();
+    try
+    {
+        std::ofstream stream(temp_fpath, std::ios::binary | std::ios::trunc);
+        const char padding[64] = {};
+        stream.write(reinterpret_cast<const char*>(head.data()), static_cast<std::streamsize>(head.size()));
+        stream.write(paths.data(), static_cast<std::streamsize>(paths.size()));
+        for (std::size_t blob = 0; blob < blob_entries.size(); ++blob)
+        {
+            for (std::uint64_t padding_size = blob_offsets[blob] - written_size; padding_size > 0;)
+            {
+                const std::size_t size = std::min<std::uint64_t>(padding_size, sizeof(padding));
+                stream.write(padding, static_cast<std::streamsize>(size));
+                padding_size -= size;
+            }
+            const std::size_t blob_entry = blob_entries[blob];
+            const entry_source& source = entries[blob_entry]->second;
+            std::unique_ptr<const entry_contents> contents = blob_entry < compared_contents.size()
+                                                                 ? std::move(compared_contents[blob_entry])
+                                                                 : nullptr;
+            if (!contents)
+                contents = std::make_unique<const entry_contents>(source);
+            if (contents->bytes().size() != sizes[blob_entry]) [[unlikely]]
+            {
+                throw std::filesystem::filesystem_error("file changed while writing resource pack",
+                                                        std::get<std::filesystem::path>(source),
+                                                        std::make_error_code(std::errc::io_error));
+            }
+            stream.write(reinterpret_cast<const char*>(contents->bytes().data()),
+                         static_cast<std::streamsize>(contents->bytes().size()));
+            written_size = blob_offsets[blob] + contents->bytes().size();
+        }
+        stream.close();
+        if (!stream) [[unlikely]]
+        {
+            throw std::filesystem::filesystem_error("cannot write resource pack", temp_fpath,
+                                                    std::make_error_code(std::errc::io_error));
+        }
+        std::filesystem::rename(temp_fpath, fpath);
+    }
+    catch (...)
+    {
+        std::error_code error_code;
+        std::filesystem::remove(temp_fpath, error_code);
+        throw;
+    }
+    return write_summary{ entries.size(), blob_entries.size(), written_size };
+}
+
+} // namespace rsce
+} // namespace arba
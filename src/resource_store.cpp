@@ -5,10 +5,20 @@ inline namespace arba
 namespace rsce
 {
 
+std::uint64_t resource_store_base::generate_store_id_() noexcept
+{
+    static std::atomic_uint64_t last_store_id = 0;
+    return ++last_store_id;
+}
+
 std::size_t resource_store_base::filesystem_path_hash::operator()(const std::filesystem::path& arg) const noexcept
 {
-    using path_string_view = std::basic_string_view<std::filesystem::path::value_type>;
-    return std::hash<path_string_view>{}(path_string_view(arg.native()));
+    return (*this)(path_string_view(arg.native()));
+}
+
+std::size_t resource_store_base::filesystem_path_hash::operator()(path_string_view arg) const noexcept
+{
+    return hash_path_string(arg);
 }
 
 } // namespace rsce
@@ -0,0 +1,55 @@
+#include <arba/rsce/atomic_pointer_table.hpp>
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+// Unit tests:
+
+TEST(atomic_pointer_table_tests, try_set__unset_index__value_set)
+{
+    rsce::atomic_pointer_table<int, 4> table;
+    ASSERT_EQ(table.get(0), nullptr);
+    ASSERT_EQ(table.get(1000), nullptr);
+    for (std::size_t index : { 0, 3, 4, 11, 12, 1000 })
+    {
+        int* value_ptr = table.try_set(index, std::make_unique<int>(static_cast<int>(index)));
+        ASSERT_EQ(table.get(index), value_ptr);
+        ASSERT_EQ(*value_ptr, static_cast<int>(index));
+    }
+    ASSERT_EQ(table.get(5), nullptr);
+    int sum = 0;
+    table.for_each([&sum](int value) { sum += value; });
+    ASSERT_EQ(sum, 0 + 3 + 4 + 11 + 12 + 1000);
+}
+
+TEST(atomic_pointer_table_tests, try_set__set_index__value_kept)
+{
+    rsce::atomic_pointer_table<int> table;
+    int* value_ptr = table.try_set(40, std::make_unique<int>(1));
+    ASSERT_EQ(table.try_set(40, std::make_unique<int>(2)), value_ptr);
+    ASSERT_EQ(*table.get(40), 1);
+}
+
+TEST(atomic_pointer_table_tests, try_set__concurrent_calls__single_value)
+{
+    rsce::atomic_pointer_table<int, 4> table;
+    std::atomic_bool start = false;
+    std::vector<int*> value_ptrs(8);
+    std::vector<std::jthread> threads;
+    for (std::size_t i = 0; i < value_ptrs.size(); ++i)
+    {
+        threads.emplace_back([&, i]() {
+            while (!start)
+                std::this_thread::yield();
+            value_ptrs[i] = table.try_set(100, std::make_unique<int>(static_cast<int>(i)));
+        });
+    }
+    start = true;
+    threads.clear();
+    for (int* value_ptr : value_ptrs)
+        ASSERT_EQ(value_ptr, table.get(100));
+}
@@ -0,0 +1,73 @@
+#include <arba/rsce/atomic_snapshot.hpp>
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+// Counts its live instances.
+struct counted_value
+{
+    inline static std::atomic_int number_of_instances = 0;
+
+    counted_value() { ++number_of_instances; }
+    ~counted_value() { --number_of_instances; }
+};
+} // namespace
+
+// Unit tests:
+
+TEST(atomic_snapshot_tests, visit__stored_value__no_error)
+{
+    rsce::atomic_snapshot<std::string> snapshot(std::make_unique<const std::string>("koro"));
+    std::string value;
+    ASSERT_TRUE(snapshot.visit([&](const std::string& str) { value = str; }));
+    ASSERT_EQ(value, "koro");
+    snapshot.store(std::make_unique<const std::string>("tiki"));
+    ASSERT_TRUE(snapshot.visit([&](const std::string& str) { value = str; }));
+    ASSERT_EQ(value, "tiki");
+}
+
+TEST(atomic_snapshot_tests, visit__concurrent_store__no_error)
+{
+    rsce::atomic_snapshot<std::vector<int>> snapshot(std::make_unique<const std::vector<int>>(16, 0));
+    std::atomic_bool stop = false;
+    std::vector<std::jthread> readers;
+    for (int i = 0; i < 4; ++i)
+    {
+        readers.emplace_back([&]() {
+            while (!stop)
+            {
+                snapshot.visit([](const std::vector<int>& values) {
+                    for (int value : values)
+                        ASSERT_EQ(value, values.front());
+                });
+            }
+        });
+    }
+    for (int i = 1; i <= 500; ++i)
+        snapshot.store(std::make_unique<const std::vector<int>>(16, i));
+    stop = true;
+    readers.clear();
+    int value = 0;
+    snapshot.visit([&](const std::vector<int>& values) { value = values.back(); });
+    ASSERT_EQ(value, 500);
+}
+
+TEST(atomic_snapshot_tests, visit__function_throws__visited_value_destroyed_once_replaced)
+{
+    {
+        rsce::atomic_snapshot<counted_value> snapshot(std::make_unique<const counted_value>());
+        ASSERT_THROW(snapshot.visit([](const counted_value&) { throw std::runtime_error("visit"); }),
+                     std::runtime_error);
+        snapshot.store(std::make_unique<const counted_value>());
+        ASSERT_EQ(counted_value::number_of_instances, 1);
+    }
+    ASSERT_EQ(counted_value::number_of_instances, 0);
+}
@@ -5,13 +5,106 @@
 #include <gtest/gtest.h>
 
 #include <array>
+#include <atomic>
+#include <chrono>
 #include <cstdlib>
 #include <fstream>
 #include <functional>
+#include <future>
+#include <latch>
 #include <string>
 
 using text_mngr_sptr = rsce::resource_store<text_mngr>::resource_sptr;
 
+// Composite resource loading two sub-resources asynchronously, from its loader, at each level.
+template <unsigned depth>
+class nested_text
+{
+public:
+    std::shared_ptr<nested_text<depth - 1>> first;
+    std::shared_ptr<nested_text<depth - 1>> second;
+
+    bool load_from_file(const std::filesystem::path& fpath, rsce::basic_resource_manager& rmanager)
+    {
+        rsce::resource_future<nested_text<depth - 1>> first_future =
+            rmanager.get_shared_async<nested_text<depth - 1>>(fpath.parent_path() / "koro.txt");
+        rsce::resource_future<nested_text<depth - 1>> second_future =
+            rmanager.get_shared_async<nested_text<depth - 1>>(fpath.parent_path() / "tiki.txt");
+        first = first_future.get();
+        second = second_future.get();
+        return first && second;
+    }
+};
+
+template <>
+class nested_text<0> : public text_mngr
+{
+};
+
+// Lets a test block the next load of a gated resource type until it opens it.
+struct load_gate
+{
+    std::latch entered{ 1 };
+    std::promise<void> open;
+    std::shared_future<void> opened = open.get_future().share();
+
+    // Called by the armed loader.
+    inline void pass()
+    {
+        entered.count_down();
+        opened.wait();
+    }
+};
+
+class gated_text_mngr : public text_mngr
+{
+public:
+    // Armed by a test, and disarmed by the load it blocks.
+    inline static std::atomic<load_gate*> gate = nullptr;
+
+    bool load_from_file(const std::filesystem::path& fpath, rsce::basic_resource_manager& rmanager)
+    {
+        if (load_gate* next_gate = gate.exchange(nullptr))
+            next_gate->pass();
+        return text_mngr::load_from_file(fpath, rmanager);
+    }
+};
+
+// Loads gated_text_mngr "tiki.txt" from its loader, once its own gate, if armed, is opened.
+class outer_text
+{
+public:
+    inline static std::atomic<load_gate*> gate = nullptr;
+
+    std::shared_ptr<gated_text_mngr> inner;
+
+    bool load_from_file(const std::filesystem::path& fpath, rsce::basic_resource_manager& rmanager)
+    {
+        if (load_gate* next_gate = gate.exchange(nullptr))
+            next_gate->pass();
+        inner = rmanager.get_shared<gated_text_mngr>(fpath.parent_path() / "tiki.txt");
+        return inner != nullptr;
+    }
+};
+
+// Loads outer_text from its loader: the nesting of outer_text, reversed.
+class outer_outer_text
+{
+public:
+    // Set when the next load starts, if armed.
+    inline static std::atomic<std::promise<void>*> started = nullptr;
+
+    std::shared_ptr<outer_text> outer;
+
+    bool load_from_file(const std::filesystem::path& fpath, rsce::basic_resource_manager& rmanager)
+    {
+        if (std::promise<void>* started_promise = started.exchange(nullptr))
+            started_promise->set_value();
+        outer = rmanager.get_shared<outer_text>(fpath);
+        return outer != nullptr;
+    }
+};
+
 // Unit tests:
 
 TEST(basic_resource_manager_mngr_tests, get_shared__resource_file_exists__no_exception)
@@ -41,3 +134,62 @@ TEST(basic_resource_manager_mngr_tests, load__resource_file_exists__expect_no_ex
     ASSERT_NE(koro_sptr, koro_2_sptr);
     ASSERT_EQ(koro_sptr->contents, koro_2_sptr->contents);
 }
+
+TEST(basic_resource_manager_mngr_tests, get_shared_async__nested_loadings_single_loader_thread__no_deadlock)
+{
+    std::filesystem::path rsc = textdir();
+
+    rsce::basic_resource_manager rmanager(1);
+    std::shared_ptr<nested_text<5>> rsc_sptr = rmanager.get_shared_async<nested_text<5>>(rsc / "koro.txt").get();
+    ASSERT_NE(rsc_sptr, nullptr);
+    ASSERT_EQ(rsc_sptr->first->first->first->first->first->contents, koro_contents());
+    ASSERT_EQ(rsc_sptr->second->second->second->second->second->contents, tiki_contents());
+    ASSERT_EQ(rsc_sptr->first->second, rsc_sptr->second->second);
+    ASSERT_EQ(rmanager.number_of_resources<nested_text<1>>(), 2);
+}
+
+TEST(basic_resource_manager_mngr_tests, get_shared_async__shared_executor__no_deadlock)
+{
+    std::filesystem::path rsc = textdir();
+
+    std::shared_ptr executor = std::make_shared<rsce::loader_thread_pool>(2);
+    rsce::basic_resource_manager rmanager(executor);
+    rsce::basic_resource_manager rmanager_2(executor);
+    rsce::resource_future<nested_text<4>> rsc_future = rmanager.get_shared_async<nested_text<4>>(rsc / "koro.txt");
+    rsce::resource_future<nested_text<4>> rsc_future_2 =
+        rmanager_2.get_shared_async<nested_text<4>>(rsc / "tiki.txt");
+    ASSERT_EQ(rsc_future.get()->first->first->first->first->contents, koro_contents());
+    ASSERT_EQ(rsc_future_2.get()->second->second->second->second->contents, tiki_contents());
+    ASSERT_NE(rsc_future.get()->first, rsc_future_2.get()->first);
+}
+
+TEST(basic_resource_manager_mngr_tests, get_shared_async__nested_loading_joined_while_waiting__no_deadlock)
+{
+    std::filesystem::path rsc = textdir();
+
+    rsce::basic_resource_manager rmanager(2);
+    // First loader thread: loads tiki.txt, blocked.
+    load_gate inner_gate;
+    gated_text_mngr::gate = &inner_gate;
+    rsce::resource_future<gated_text_mngr> inner_future = rmanager.get_shared_async<gated_text_mngr>(rsc / "tiki.txt");
+    inner_gate.entered.wait();
+    // Second loader thread: loads koro.txt, which will wait for tiki.txt.
+    load_gate outer_gate;
+    outer_text::gate = &outer_gate;
+    rsce::resource_future<outer_text> outer_future = rmanager.get_shared_async<outer_text>(rsc / "koro.txt");
+    outer_gate.entered.wait();
+    // Queued while both threads are busy: its loader joins the loading of koro.txt. The second thread must not run
+    // it while it waits for tiki.txt, under the loading of koro.txt.
+    std::promise<void> outer_outer_started;
+    outer_outer_text::started = &outer_outer_started;
+    rsce::resource_future<outer_outer_text> outer_outer_future =
+        rmanager.get_shared_async<outer_outer_text>(rsc / "koro.txt");
+    outer_gate.open.set_value();
+    // Gives the second thread the time to wait for tiki.txt, and to wrongly start the queued loading meanwhile.
+    outer_outer_started.get_future().wait_for(std::chrono::milliseconds(100));
+    outer_outer_text::started = nullptr;
+    inner_gate.open.set_value();
+    ASSERT_EQ(outer_outer_future.get()->outer, outer_future.get());
+    ASSERT_EQ(outer_future.get()->inner, inner_future.get());
+    ASSERT_EQ(inner_future.get()->contents, tiki_contents());
+}
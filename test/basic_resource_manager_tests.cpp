@@ -1,14 +1,18 @@
 #include "resources/resources_helper.hpp"
+#include "resources/story.hpp"
 #include "resources/text.hpp"
 #include <arba/rsce/basic_resource_manager.hpp>
 
 #include <gtest/gtest.h>
 
 #include <array>
+#include <atomic>
 #include <cstdlib>
 #include <fstream>
 #include <functional>
 #include <string>
+#include <thread>
+#include <vector>
 
 using text_sptr = rsce::resource_store<text>::resource_sptr;
 
@@ -81,6 +85,29 @@ TEST(basic_resource_manager_tests, get_shared__resource_file_does_not_exist_noth
     }
 }
 
+#ifdef ARBA_RSCE_HAS_EXPECTED
+TEST(basic_resource_manager_tests, try_get_shared__resource_file_exists__resource)
+{
+    std::filesystem::path rsc = textdir();
+
+    rsce::basic_resource_manager rmanager;
+    std::expected<text_sptr, rsce::load_error> result = rmanager.try_get_shared<text>(rsc / "tiki.txt");
+    ASSERT_TRUE(result.has_value());
+    ASSERT_EQ(*result, rmanager.get_shared<text>(rsc / "tiki.txt"));
+}
+
+TEST(basic_resource_manager_tests, try_get_shared__resource_file_does_not_exist__error)
+{
+    std::filesystem::path rsc = textdir();
+
+    rsce::basic_resource_manager rmanager;
+    std::expected<text_sptr, rsce::load_error> result = rmanager.try_get_shared<text>(rsc / "not_found.txt");
+    ASSERT_FALSE(result.has_value());
+    ASSERT_EQ(result.error().code, std::errc::no_such_file_or_directory);
+    ASSERT_EQ(result.error().path, rsc / "not_found.txt");
+}
+#endif
+
 TEST(basic_resource_manager_tests, load__resource_file_exists__expect_no_exception)
 {
     std::filesystem::path rsc = textdir();
@@ -160,6 +187,29 @@ TEST(basic_resource_manager_tests, insert__rsc_sptr__no_error)
     ASSERT_EQ(tale_sptr, rmanager.get_shared<text>("default_tale"));
 }
 
+TEST(basic_resource_manager_tests, insert__concurrent_first_inserts__no_store_replaced)
+{
+    constexpr std::size_t number_of_threads = 8;
+
+    for (int iteration = 0; iteration < 20; ++iteration)
+    {
+        rsce::basic_resource_manager rmanager;
+        std::atomic_bool start = false;
+        std::vector<std::jthread> threads;
+        for (std::size_t i = 0; i < number_of_threads; ++i)
+        {
+            threads.emplace_back([&rmanager, &start, i]() {
+                while (!start)
+                    std::this_thread::yield();
+                rmanager.insert("tale_" + std::to_string(i), std::make_shared<story>());
+            });
+        }
+        start = true;
+        threads.clear();
+        ASSERT_EQ(rmanager.number_of_resources<story>(), number_of_threads);
+    }
+}
+
 TEST(basic_resource_manager_tests, set__rsc_sptr__no_error)
 {
     rsce::basic_resource_manager rmanager;
@@ -243,3 +293,149 @@ TEST(basic_resource_manager_tests, test_unordered_store_creation)
         ASSERT_EQ(green_tiki_sptr, green_tiki_sptr_2);
     }
 }
+
+TEST(basic_resource_manager_tests, get_shared_async__resource_files_exist__no_exception)
+{
+    std::filesystem::path rsc = textdir();
+
+    rsce::basic_resource_manager rmanager(2);
+    rsce::resource_future<text> koro_future = rmanager.get_shared_async<text>(rsc / "koro.txt");
+    rsce::resource_future<text> tiki_future = rmanager.get_shared_async<text>(rsc / "tiki.txt");
+    rsce::resource_future<text> koro_future_2 = rmanager.get_shared_async<text>(rsc / "koro.txt");
+    ASSERT_NE(koro_future.get(), nullptr);
+    ASSERT_EQ(koro_future.get(), koro_future_2.get());
+    ASSERT_EQ(koro_future.get()->contents, koro_contents());
+    ASSERT_EQ(tiki_future.get()->contents, tiki_contents());
+    ASSERT_EQ(koro_future.get(), rmanager.get_shared<text>(rsc / "koro.txt"));
+    ASSERT_EQ(rmanager.number_of_resources<text>(), 2);
+}
+
+TEST(basic_resource_manager_tests, get_shared_async__0_loader_threads__resource_loaded)
+{
+    std::filesystem::path rsc = textdir();
+
+    rsce::basic_resource_manager rmanager(0);
+    rsce::resource_future<text> koro_future = rmanager.get_shared_async<text>(rsc / "koro.txt");
+    // Loaded by a loader thread: get() would load it on this thread.
+    while (!koro_future.is_ready())
+        std::this_thread::yield();
+    ASSERT_EQ(koro_future.get()->contents, koro_contents());
+}
+
+TEST(basic_resource_manager_tests, get_shared_async__resource_file_does_not_exist__exception_on_get)
+{
+    std::filesystem::path rsc = textdir();
+
+    rsce::basic_resource_manager rmanager(2);
+    rsce::resource_future<text> rsc_future = rmanager.get_shared_async<text>(rsc / "not_found.txt");
+    rsce::resource_future<story> invalid_future = rmanager.get_shared_async<story>(rsc / "invalid.txt");
+    ASSERT_THROW(rsc_future.get(), std::runtime_error);
+    ASSERT_THROW(invalid_future.get(), std::runtime_error);
+    ASSERT_EQ(rmanager.number_of_resources<text>(), 0);
+    ASSERT_EQ(rmanager.number_of_resources<story>(), 0);
+}
+
+TEST(basic_resource_manager_tests, load_async__resource_file_exists__no_exception)
+{
+    std::filesystem::path rsc = textdir();
+
+    rsce::basic_resource_manager rmanager(2);
+    text_sptr koro_sptr = rmanager.get_shared<text>(rsc / "koro.txt");
+    rsce::resource_future<text> koro_future = rmanager.load_async<text>(rsc / "koro.txt");
+    ASSERT_NE(koro_future.get(), koro_sptr);
+    ASSERT_EQ(koro_future.get()->contents, koro_sptr->contents);
+    ASSERT_EQ(rmanager.number_of_resources<text>(), 1);
+}
+
+TEST(basic_resource_manager_tests, preload__resource_files_exist__no_exception)
+{
+    std::filesystem::path rsc = textdir();
+
+    rsce::basic_resource_manager rmanager(2);
+    const std::array rsc_paths{ rsc / "koro.txt", rsc / "tiki.txt" };
+    rmanager.preload<text>(rsc_paths);
+    ASSERT_EQ(rmanager.number_of_resources<text>(), 2);
+    ASSERT_EQ(rmanager.get<text>(rsc / "koro.txt").contents, koro_contents());
+    ASSERT_THROW(rmanager.preload<story>(std::array{ rsc / "invalid.txt" }), std::runtime_error);
+    ASSERT_EQ(rmanager.number_of_resources<story>(), 0);
+}
+
+TEST(basic_resource_manager_tests, preload__entries_of_several_types__no_exception)
+{
+    std::filesystem::path rsc = textdir();
+
+    rsce::basic_resource_manager rmanager(2);
+    const std::array entries{ rsce::resource_preload_entry::make<text>(rsc / "koro.txt"),
+                              rsce::resource_preload_entry::make<red_text>(rsc / "koro.txt"),
+                              rsce::resource_preload_entry::make<text>(rsc / "tiki.txt"),
+                              rsce::resource_preload_entry::make<green_text>(rsc / "tiki.txt") };
+    rmanager.preload(entries);
+    ASSERT_EQ(rmanager.number_of_resources<text>(), 2);
+    ASSERT_EQ(rmanager.number_of_resources<red_text>(), 1);
+    ASSERT_EQ(rmanager.number_of_resources<green_text>(), 1);
+    ASSERT_EQ(rmanager.get<green_text>(rsc / "tiki.txt").contents, tiki_contents());
+}
+
+TEST(basic_resource_manager_tests, preload_directory__extension__summary)
+{
+    std::filesystem::path rsc = textdir();
+
+    rsce::basic_resource_manager rmanager(2);
+    rsce::resource_preload_summary summary = rmanager.preload_directory<story>(rscdir(), true, ".txt");
+    ASSERT_EQ(summary.number_of_resources, 2);
+    ASSERT_EQ(summary.number_of_bytes, koro_contents().size() + tiki_contents().size());
+    ASSERT_EQ(summary.failures.size(), 1);
+    ASSERT_EQ(std::filesystem::canonical(summary.failures.front().path), rsc / "invalid.txt");
+    ASSERT_GT(summary.duration.count(), 0);
+    ASSERT_EQ(rmanager.number_of_resources<story>(), 2);
+
+    summary = rmanager.preload_directory<story>(rscdir(), false, ".txt");
+    ASSERT_EQ(summary.number_of_resources, 0);
+    ASSERT_TRUE(summary.failures.empty());
+}
+
+TEST(basic_resource_manager_tests, preload_directory__predicate__summary)
+{
+    std::filesystem::path rsc = textdir();
+
+    rsce::basic_resource_manager rmanager(2);
+    rsce::resource_preload_summary summary = rmanager.preload_directory<text>(
+        rsc, false, [](const std::filesystem::path& fpath) { return fpath.stem() != "invalid"; });
+    ASSERT_EQ(summary.number_of_resources, 2);
+    ASSERT_TRUE(summary.failures.empty());
+    ASSERT_EQ(rmanager.get<text>(rsc / "tiki.txt").contents, tiki_contents());
+}
+
+TEST(basic_resource_manager_tests, get_shared__string_view__no_exception)
+{
+    const std::string koro_path = (textdir() / "koro.txt").string();
+
+    rsce::basic_resource_manager rmanager;
+    text_sptr koro_sptr = rmanager.get_shared<text>(std::string_view(koro_path));
+    ASSERT_EQ(rmanager.get_shared<text>(koro_path), koro_sptr);
+    ASSERT_EQ(rmanager.get<text>(koro_path.c_str()).contents, koro_contents());
+    ASSERT_EQ(rmanager.number_of_resources<text>(), 1);
+}
+
+TEST(basic_resource_manager_tests, get_shared__hashed_path__no_exception)
+{
+    const rsce::hashed_path koro_path(textdir() / "koro.txt");
+
+    rsce::basic_resource_manager rmanager;
+    text_sptr koro_sptr = rmanager.get_shared<text>(koro_path);
+    ASSERT_EQ(koro_sptr->contents, koro_contents());
+    ASSERT_EQ(rmanager.get_shared<text>(koro_path.path()), koro_sptr);
+    ASSERT_EQ(&rmanager.get<text>(koro_path), koro_sptr.get());
+    ASSERT_EQ(rmanager.number_of_resources<text>(), 1);
+}
+
+TEST(basic_resource_manager_tests, get_handle__resource_file_exists__valid_handle)
+{
+    std::filesystem::path rsc = textdir();
+
+    rsce::basic_resource_manager rmanager;
+    rsce::resource_handle<text> koro_handle = rmanager.get_handle<text>(rsc / "koro.txt");
+    ASSERT_EQ(koro_handle->contents, koro_contents());
+    ASSERT_EQ(koro_handle.pin(), rmanager.get_shared<text>(rsc / "koro.txt"));
+    ASSERT_THROW(rmanager.get_handle<text>(rsc / "not_found.txt"), std::filesystem::filesystem_error);
+}
@@ -0,0 +1,172 @@
+#include <arba/rsce/flat_hash_map.hpp>
+
+#include <gtest/gtest.h>
+
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+
+using string_map = rsce::flat_hash_map<std::string, int, std::hash<std::string_view>, std::equal_to<>>;
+
+// Hash with many collisions, to test the probing of several groups.
+struct colliding_hash
+{
+    std::size_t operator()(int value) const { return static_cast<std::size_t>(value % 3) << 7; }
+};
+using colliding_map = rsce::flat_hash_map<int, int, colliding_hash, std::equal_to<>>;
+
+// Hash whose 7 lowest bits are the same for all keys, as for the keys of a shard of a resource store.
+struct same_low_bits_hash
+{
+    std::size_t operator()(std::string_view value) const
+    {
+        return (std::hash<std::string_view>{}(value) & ~std::size_t(0x7F)) | 0x2A;
+    }
+};
+using same_low_bits_map = rsce::flat_hash_map<std::string, int, same_low_bits_hash, std::equal_to<>>;
+
+// Value whose copy throws if throws_on_copy is true.
+struct copy_throwing_value
+{
+    copy_throwing_value(std::shared_ptr<int> value, bool throws_on_copy)
+        : value(std::move(value)), throws_on_copy(throws_on_copy)
+    {
+    }
+    copy_throwing_value(copy_throwing_value&&) = default;
+    copy_throwing_value(const copy_throwing_value& other) : value(other.value), throws_on_copy(other.throws_on_copy)
+    {
+        if (throws_on_copy)
+            throw std::runtime_error("Copy failure.");
+    }
+
+    std::shared_ptr<int> value;
+    bool throws_on_copy;
+};
+
+// Unit tests:
+
+TEST(flat_hash_map_tests, emplace__new_keys__inserted)
+{
+    string_map map;
+    ASSERT_TRUE(map.emplace("koro", 1).second);
+    ASSERT_TRUE(map.emplace("tiki", 2).second);
+    ASSERT_EQ(map.size(), 2);
+    auto [iter, inserted] = map.emplace("koro", 3);
+    ASSERT_FALSE(inserted);
+    ASSERT_EQ(iter->second, 1);
+}
+
+TEST(flat_hash_map_tests, find__string_view__found)
+{
+    string_map map;
+    map["koro"] = 1;
+    std::string_view key = "koro";
+    auto iter = map.find(key);
+    ASSERT_NE(iter, map.end());
+    ASSERT_EQ(iter->first, "koro");
+    ASSERT_EQ(iter->second, 1);
+    ASSERT_EQ(map.find(std::string_view("tiki")), map.end());
+}
+
+TEST(flat_hash_map_tests, emplace__many_keys__all_found_and_stable)
+{
+    string_map map;
+    map.emplace("0", 0);
+    const int* first_value = &map.find(std::string_view("0"))->second;
+    for (int i = 1; i < 10'000; ++i)
+        ASSERT_TRUE(map.emplace(std::to_string(i), i).second);
+    ASSERT_EQ(map.size(), 10'000);
+    for (int i = 0; i < 10'000; ++i)
+    {
+        auto iter = map.find(std::to_string(i));
+        ASSERT_NE(iter, map.end());
+        ASSERT_EQ(iter->second, i);
+    }
+    ASSERT_EQ(first_value, &map.find(std::string_view("0"))->second);
+}
+
+TEST(flat_hash_map_tests, erase__colliding_keys__other_keys_found)
+{
+    colliding_map map;
+    for (int i = 0; i < 300; ++i)
+        map.emplace(i, i);
+    for (int i = 0; i < 300; i += 2)
+        ASSERT_EQ(map.erase(i), 1);
+    ASSERT_EQ(map.erase(0), 0);
+    ASSERT_EQ(map.size(), 150);
+    for (int i = 0; i < 300; ++i)
+        ASSERT_EQ(map.contains(i), i % 2 == 1);
+    for (int i = 0; i < 300; i += 2)
+        map.emplace(i, -i);
+    ASSERT_EQ(map.size(), 300);
+    ASSERT_EQ(map.find(4)->second, -4);
+}
+
+TEST(flat_hash_map_tests, emplace__same_low_hash_bits__all_found)
+{
+    same_low_bits_map map;
+    for (int i = 0; i < 1000; ++i)
+        ASSERT_TRUE(map.emplace("key_" + std::to_string(i), i).second);
+    ASSERT_EQ(map.size(), 1000);
+    for (int i = 0; i < 1000; ++i)
+        ASSERT_EQ(map.find(std::string_view("key_" + std::to_string(i)))->second, i);
+    ASSERT_FALSE(map.contains(std::string_view("key_1000")));
+}
+
+TEST(flat_hash_map_tests, erase_emplace__repeated__size_bounded)
+{
+    string_map map;
+    for (int i = 0; i < 100'000; ++i)
+    {
+        map.emplace(std::to_string(i), i);
+        map.erase(std::to_string(i));
+    }
+    ASSERT_TRUE(map.empty());
+    ASSERT_EQ(map.begin(), map.end());
+}
+
+TEST(flat_hash_map_tests, copy__filled_map__equal_maps)
+{
+    string_map map;
+    for (int i = 0; i < 100; ++i)
+        map.emplace(std::to_string(i), i);
+    string_map copy(map);
+    map.clear();
+    ASSERT_TRUE(map.empty());
+    ASSERT_EQ(copy.size(), 100);
+    int sum = 0;
+    for (const auto& [key, value] : copy)
+    {
+        ASSERT_EQ(key, std::to_string(value));
+        sum += value;
+    }
+    ASSERT_EQ(sum, 99 * 100 / 2);
+}
+
+TEST(flat_hash_map_tests, copy__throwing_value_copy__copied_values_released)
+{
+    rsce::flat_hash_map<std::string, copy_throwing_value, std::hash<std::string_view>, std::equal_to<>> map;
+    std::shared_ptr<int> value = std::make_shared<int>(5);
+    for (int i = 0; i < 100; ++i)
+        map.emplace(std::to_string(i), copy_throwing_value(value, i == 50));
+    ASSERT_EQ(value.use_count(), 101);
+    ASSERT_THROW(auto copy(map), std::runtime_error);
+    ASSERT_EQ(value.use_count(), 101);
+}
+
+TEST(flat_hash_map_tests, clear__shared_ptr_values__values_released)
+{
+    rsce::flat_hash_map<std::string, std::shared_ptr<int>, std::hash<std::string_view>, std::equal_to<>> map;
+    std::shared_ptr<int> value = std::make_shared<int>(5);
+    map.emplace("koro", value);
+    map.reserve(1000);
+    ASSERT_EQ(value.use_count(), 2);
+    map.clear();
+    ASSERT_EQ(value.use_count(), 1);
+    map.emplace("koro", value);
+    map.erase(std::string_view("koro"));
+    ASSERT_EQ(value.use_count(), 1);
+}
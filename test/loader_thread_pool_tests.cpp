@@ -0,0 +1,53 @@
+#include <arba/rsce/loader_thread_pool.hpp>
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <future>
+
+TEST(loader_thread_pool_tests, destructor__pending_tasks__tasks_run)
+{
+    std::atomic_int counter = 0;
+    {
+        rsce::loader_thread_pool pool(2);
+        for (int i = 0; i < 100; ++i)
+            pool.submit([&counter]() { ++counter; });
+    }
+    ASSERT_EQ(counter, 100);
+}
+
+TEST(loader_thread_pool_tests, constructor__0_threads__1_thread)
+{
+    std::atomic_int counter = 0;
+    {
+        rsce::loader_thread_pool pool(0);
+        ASSERT_EQ(pool.number_of_threads(), 1);
+        pool.submit([&counter]() { ++counter; });
+    }
+    ASSERT_EQ(counter, 1);
+}
+
+TEST(loader_thread_pool_tests, submit__nested_tasks_single_thread__no_deadlock)
+{
+    rsce::loader_thread_pool pool(1);
+    std::promise<int> result_promise;
+    pool.submit([&pool, &result_promise]() {
+        ASSERT_EQ(rsce::loader_executor::current_thread_executor(), &pool);
+        std::promise<int> nested_promise;
+        std::future<int> nested_future = nested_promise.get_future();
+        pool.submit([&nested_promise]() { nested_promise.set_value(42); });
+        while (nested_future.wait_for(std::chrono::seconds(0)) != std::future_status::ready
+               && pool.try_run_pending_task())
+        {
+        }
+        result_promise.set_value(nested_future.get());
+    });
+    ASSERT_EQ(result_promise.get_future().get(), 42);
+    ASSERT_EQ(rsce::loader_executor::current_thread_executor(), nullptr);
+}
+
+TEST(loader_thread_pool_tests, try_run_pending_task__no_task__false)
+{
+    rsce::loader_thread_pool pool(1);
+    ASSERT_FALSE(pool.try_run_pending_task());
+}
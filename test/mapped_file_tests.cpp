@@ -0,0 +1,76 @@
+#include <arba/rsce/mapped_file.hpp>
+
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+
+namespace
+{
+std::filesystem::path write_temp_file(std::string_view name, std::string_view contents)
+{
+    std::filesystem::path fpath = std::filesystem::temp_directory_path() / name;
+    std::ofstream(fpath, std::ios::binary) << contents;
+    return fpath;
+}
+
+std::string_view as_string_view(std::span<const std::byte> bytes)
+{
+    return std::string_view(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+}
+} // namespace
+
+// Unit tests:
+
+TEST(mapped_file_tests, constructor__existing_file__contents_mapped)
+{
+    std::filesystem::path fpath = write_temp_file("rsce_mapped_file_tests.bin", "mapped contents");
+    {
+        rsce::mapped_file file(fpath);
+        ASSERT_EQ(file.size(), 15);
+        ASSERT_EQ(as_string_view(file.bytes()), "mapped contents");
+    }
+    std::filesystem::remove(fpath);
+}
+
+TEST(mapped_file_tests, constructor__empty_file__empty_bytes)
+{
+    std::filesystem::path fpath = write_temp_file("rsce_mapped_file_tests_empty.bin", "");
+    {
+        std::error_code error_code;
+        rsce::mapped_file file(fpath, error_code);
+        ASSERT_FALSE(error_code);
+        ASSERT_TRUE(file.bytes().empty());
+    }
+    std::filesystem::remove(fpath);
+}
+
+TEST(mapped_file_tests, constructor__file_does_not_exist__error)
+{
+    std::filesystem::path fpath = std::filesystem::temp_directory_path() / "rsce_mapped_file_tests_not_found.bin";
+    std::error_code error_code;
+    rsce::mapped_file file(fpath, error_code);
+    ASSERT_EQ(error_code, std::errc::no_such_file_or_directory);
+    ASSERT_EQ(file.data(), nullptr);
+    ASSERT_THROW(rsce::mapped_file{ fpath }, std::filesystem::filesystem_error);
+}
+
+TEST(mapped_file_tests, move__mapped_file__mapping_moved)
+{
+    std::filesystem::path fpath = write_temp_file("rsce_mapped_file_tests_move.bin", "moved");
+    {
+        rsce::mapped_file file(fpath);
+        const std::byte* data = file.data();
+        rsce::mapped_file other_file(std::move(file));
+        ASSERT_EQ(file.data(), nullptr);
+        ASSERT_EQ(other_file.data(), data);
+        file = std::move(other_file);
+        ASSERT_EQ(as_string_view(file.bytes()), "moved");
+    }
+    std::filesystem::remove(fpath);
+}
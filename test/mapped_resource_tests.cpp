@@ -0,0 +1,91 @@
+#include <arba/rsce/load_resource_from_file.hpp>
+#include <arba/rsce/mapped_resource.hpp>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <span>
+#include <string>
+#include <system_error>
+
+static_assert(rsce::traits::is_loadable_resource_v<rsce::mapped_blob>);
+static_assert(rsce::traits::is_loadable_resource_v<rsce::mapped_resource<std::uint32_t>>);
+
+namespace
+{
+// Loadable with map_file(), load_from_file() and load_from_memory(): load_resource_from_file() calls map_file().
+class multi_loader_resource
+{
+public:
+    static std::shared_ptr<multi_loader_resource> map_file(const std::filesystem::path&)
+    {
+        std::shared_ptr rsc_sptr = std::make_shared<multi_loader_resource>();
+        rsc_sptr->loader = "map_file";
+        return rsc_sptr;
+    }
+
+    bool load_from_file(const std::filesystem::path&)
+    {
+        loader = "load_from_file";
+        return true;
+    }
+
+    bool load_from_memory(std::span<const std::byte>)
+    {
+        loader = "load_from_memory";
+        return true;
+    }
+
+    std::string loader;
+};
+} // namespace
+
+// Unit tests:
+
+TEST(mapped_resource_tests, map_file__file_of_elements__elements_in_mapping)
+{
+    std::filesystem::path fpath = std::filesystem::temp_directory_path() / "rsce_mapped_resource_tests.bin";
+    const std::array<std::uint32_t, 3> values{ 7, 11, 13 };
+    std::ofstream(fpath, std::ios::binary).write(reinterpret_cast<const char*>(values.data()), sizeof(values));
+    {
+        std::shared_ptr rsc_sptr = rsce::load_resource_from_file<rsce::mapped_resource<std::uint32_t>>(fpath);
+        ASSERT_EQ(rsc_sptr->size(), values.size());
+        ASSERT_TRUE(std::ranges::equal(*rsc_sptr, values));
+        ASSERT_EQ(rsc_sptr->bytes().size(), sizeof(values));
+
+        std::shared_ptr blob_sptr = rsce::load_resource_from_file<rsce::mapped_blob>(fpath);
+        ASSERT_EQ(blob_sptr->size(), sizeof(values));
+        ASSERT_NE(static_cast<const void*>(blob_sptr->data()), static_cast<const void*>(rsc_sptr->data()));
+    }
+    std::filesystem::remove(fpath);
+}
+
+TEST(mapped_resource_tests, map_file__size_not_multiple_of_element_size__exception)
+{
+    std::filesystem::path fpath = std::filesystem::temp_directory_path() / "rsce_mapped_resource_tests_odd.bin";
+    std::ofstream(fpath, std::ios::binary) << "12345";
+    ASSERT_THROW(rsce::mapped_resource<std::uint32_t>::map_file(fpath), std::filesystem::filesystem_error);
+    ASSERT_EQ(rsce::mapped_blob::map_file(fpath)->size(), 5);
+    std::filesystem::remove(fpath);
+}
+
+TEST(mapped_resource_tests, map_file__file_does_not_exist__exception)
+{
+    std::filesystem::path fpath = std::filesystem::temp_directory_path() / "rsce_mapped_resource_tests_none.bin";
+    ASSERT_THROW(rsce::mapped_blob::map_file(fpath), std::filesystem::filesystem_error);
+}
+
+TEST(mapped_resource_tests, load_resource_from_file__several_loaders__map_file_called)
+{
+    std::filesystem::path fpath = std::filesystem::temp_directory_path() / "rsce_mapped_resource_tests_multi.bin";
+    std::ofstream(fpath, std::ios::binary) << "12345";
+    ASSERT_EQ(rsce::load_resource_from_file<multi_loader_resource>(fpath)->loader, "map_file");
+    std::error_code error_code;
+    ASSERT_EQ(rsce::load_resource_from_file<multi_loader_resource>(fpath, error_code)->loader, "map_file");
+    std::filesystem::remove(fpath);
+}
@@ -0,0 +1,69 @@
+#include <arba/rsce/memory_stream.hpp>
+
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <iterator>
+#include <span>
+#include <string>
+#include <string_view>
+
+namespace
+{
+std::span<const std::byte> as_bytes(std::string_view contents)
+{
+    return std::as_bytes(std::span<const char>(contents.data(), contents.size()));
+}
+} // namespace
+
+// Unit tests:
+
+TEST(memory_stream_tests, read__lines__contents)
+{
+    rsce::memory_istream stream(as_bytes("first line\nsecond line"));
+    std::string line;
+    ASSERT_TRUE(std::getline(stream, line));
+    ASSERT_EQ(line, "first line");
+    ASSERT_TRUE(std::getline(stream, line));
+    ASSERT_EQ(line, "second line");
+    ASSERT_FALSE(std::getline(stream, line));
+    ASSERT_TRUE(stream.eof());
+}
+
+TEST(memory_stream_tests, seekg_tellg__whole_stream__size_then_contents)
+{
+    constexpr std::string_view contents = "0123456789";
+    rsce::memory_istream stream(as_bytes(contents));
+    stream.seekg(0, std::ios::end);
+    ASSERT_EQ(stream.tellg(), 10);
+    stream.seekg(0, std::ios::beg);
+    ASSERT_EQ(std::string(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>()), contents);
+    stream.clear();
+    stream.seekg(-3, std::ios::end);
+    ASSERT_EQ(stream.get(), '7');
+    stream.seekg(1, std::ios::cur);
+    ASSERT_EQ(stream.tellg(), 9);
+    stream.seekg(4);
+    char chars[3];
+    ASSERT_TRUE(stream.read(chars, 3));
+    ASSERT_EQ(std::string_view(chars, 3), "456");
+}
+
+TEST(memory_stream_tests, seekg__out_of_range__fail)
+{
+    rsce::memory_istream stream(as_bytes("abc"));
+    stream.seekg(4);
+    ASSERT_TRUE(stream.fail());
+    stream.clear();
+    stream.seekg(-1, std::ios::beg);
+    ASSERT_TRUE(stream.fail());
+    stream.clear();
+    ASSERT_EQ(stream.tellg(), 0);
+}
+
+TEST(memory_stream_tests, read__empty_bytes__eof)
+{
+    rsce::memory_istream stream(std::span<const std::byte>{});
+    ASSERT_EQ(stream.get(), std::char_traits<char>::eof());
+    ASSERT_TRUE(stream.eof());
+}
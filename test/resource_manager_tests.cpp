@@ -1,17 +1,59 @@
+#include "resources/memory_rsc.hpp"
 #include "resources/resources_helper.hpp"
+#include "resources/stream_text_rsc.hpp"
 #include "resources/text.hpp"
 #include <arba/rsce/resource_manager.hpp>
 
 #include <gtest/gtest.h>
 
 #include <array>
+#include <cstddef>
 #include <cstdlib>
 #include <fstream>
 #include <functional>
+#include <stdexcept>
 #include <string>
+#include <string_view>
+#include <vector>
 
 using text_sptr = rsce::resource_store<text>::resource_sptr;
 
+namespace
+{
+std::vector<std::byte> as_bytes(std::string_view contents)
+{
+    const std::byte* data = reinterpret_cast<const std::byte*>(contents.data());
+    return std::vector<std::byte>(data, data + contents.size());
+}
+
+// Pack of the text resources, in the directory text.
+std::filesystem::path write_text_pack(std::string_view name)
+{
+    rsce::resource_pack_builder builder;
+    builder.add("text/koro.txt", as_bytes(koro_contents()));
+    builder.add("text/tiki.txt", as_bytes(tiki_contents()));
+    builder.add("text/invalid.txt", as_bytes(invalid_contents()));
+    std::filesystem::path fpath = std::filesystem::temp_directory_path() / name;
+    builder.write(fpath);
+    return fpath;
+}
+
+// Returns true if function throws a filesystem error of code load_errc::pack_path_not_supported.
+template <class function_type>
+bool rejects_pack_path(function_type function)
+{
+    try
+    {
+        function();
+    }
+    catch (const std::filesystem::filesystem_error& error)
+    {
+        return error.code() == rsce::load_errc::pack_path_not_supported;
+    }
+    return false;
+}
+} // namespace
+
 // Unit tests:
 
 TEST(resource_manager_tests, constructor__no_arg__no_error)
@@ -268,3 +310,297 @@ TEST(resource_manager_tests, remove__vlfs_rsc_path__no_error)
     rmanager.remove<text>(rsc_path);
     ASSERT_EQ(rmanager.number_of_resources<text>(), 0);
 }
+
+TEST(resource_manager_tests, get_shared_async__vlfs_resource_file_exists__no_exception)
+{
+    std::filesystem::path rsc = textdir();
+
+    vlfs::virtual_filesystem vlfs = create_vlfs();
+    rsce::resource_manager rmanager(vlfs, 2);
+    rsce::resource_future<text> koro_future = rmanager.get_shared_async<text>("TEXT:/koro.txt");
+    rsce::resource_future<text> koro_future_2 = rmanager.get_shared_async<text>(rsc / "koro.txt");
+    ASSERT_NE(koro_future.get(), nullptr);
+    ASSERT_EQ(koro_future.get(), koro_future_2.get());
+    ASSERT_EQ(koro_future.get()->contents, koro_contents());
+    ASSERT_EQ(rmanager.number_of_resources<text>(), 1);
+}
+
+TEST(resource_manager_tests, preload__vlfs_resource_files_exist__no_exception)
+{
+    std::filesystem::path rsc = textdir();
+
+    vlfs::virtual_filesystem vlfs = create_vlfs();
+    rsce::resource_manager rmanager(vlfs, 2);
+    const std::array<std::filesystem::path, 2> rsc_paths{ "TEXT:/koro.txt", rsc / "koro.txt" };
+    rmanager.preload<text>(rsc_paths);
+    ASSERT_EQ(rmanager.number_of_resources<text>(), 1);
+    const std::array entries{ rsce::resource_preload_entry::make<text>("TEXT:/tiki.txt") };
+    rmanager.preload(entries);
+    ASSERT_EQ(rmanager.number_of_resources<text>(), 2);
+    ASSERT_EQ(rmanager.get<text>("TEXT:/tiki.txt").contents, tiki_contents());
+}
+
+TEST(resource_manager_tests, preload_directory__vlfs_directory__summary)
+{
+    vlfs::virtual_filesystem vlfs = create_vlfs();
+    rsce::resource_manager rmanager(vlfs, 2);
+    rsce::resource_preload_summary summary = rmanager.preload_directory<text>("RSC:/ut");
+    ASSERT_EQ(summary.number_of_resources, 2);
+    ASSERT_EQ(summary.failures.size(), 1);
+    ASSERT_EQ(rmanager.number_of_resources<text>(), 2);
+    ASSERT_EQ(rmanager.get<text>("TEXT:/koro.txt").contents, koro_contents());
+}
+
+TEST(resource_manager_tests, get_shared__string_view__no_exception)
+{
+    vlfs::virtual_filesystem vlfs = create_vlfs();
+    rsce::resource_manager rmanager(vlfs);
+    text_sptr koro_sptr = rmanager.get_shared<text>(std::string_view("TEXT:/koro.txt"));
+    ASSERT_EQ(rmanager.get_shared<text>((textdir() / "koro.txt").string()), koro_sptr);
+    ASSERT_EQ(rmanager.get<text>("TEXT:/koro.txt").contents, koro_contents());
+    ASSERT_EQ(rmanager.number_of_resources<text>(), 1);
+}
+
+TEST(resource_manager_tests, get_shared__hashed_virtual_path__cached_spelling)
+{
+    using namespace rsce::literals;
+
+    vlfs::virtual_filesystem vlfs = create_vlfs();
+    rsce::resource_manager rmanager(vlfs);
+    ASSERT_EQ(rmanager.store<text>().find("TEXT:/koro.txt"_rsc), nullptr);
+    text_sptr koro_sptr = rmanager.get_shared<text>("TEXT:/koro.txt"_rsc);
+    ASSERT_EQ(koro_sptr->contents, koro_contents());
+    ASSERT_EQ(rmanager.store<text>().find("TEXT:/koro.txt"_rsc), koro_sptr);
+    ASSERT_EQ(rmanager.get_shared<text>("TEXT:/koro.txt"), koro_sptr);
+    ASSERT_EQ(rmanager.get<text>("TEXT:/koro.txt"_rsc).contents, koro_contents());
+    rmanager.invalidate_canonical_paths();
+    ASSERT_EQ(rmanager.store<text>().find("TEXT:/koro.txt"_rsc), nullptr);
+    ASSERT_EQ(rmanager.get_shared<text>("TEXT:/koro.txt"_rsc), koro_sptr);
+}
+
+TEST(resource_manager_tests, get_shared__vlfs_interned_path__no_exception)
+{
+    vlfs::virtual_filesystem vlfs = create_vlfs();
+    rsce::resource_manager rmanager(vlfs);
+    rsce::resource_id<text> koro_id = rmanager.intern<text>("TEXT:/koro.txt");
+    ASSERT_EQ(rmanager.intern<text>(textdir() / "koro.txt"), koro_id);
+    text_sptr koro_sptr = rmanager.get_shared(koro_id);
+    ASSERT_EQ(koro_sptr->contents, koro_contents());
+    ASSERT_EQ(rmanager.get_shared<text>("TEXT:/koro.txt"), koro_sptr);
+}
+
+TEST(resource_manager_tests, get_shared__pack_entry__loaded_from_pack)
+{
+    using namespace rsce::literals;
+
+    const std::filesystem::path pack_path = write_text_pack("rsce_resource_manager_tests_get.pack");
+    {
+        vlfs::virtual_filesystem vlfs = create_vlfs();
+        rsce::resource_manager rmanager(vlfs);
+        rmanager.mount_pack("PACK", pack_path);
+        std::shared_ptr<memory_rsc> koro_sptr = rmanager.get_shared<memory_rsc>("PACK:/text/koro.txt");
+        ASSERT_EQ(koro_sptr->contents, koro_contents());
+        ASSERT_EQ(rmanager.get_shared<memory_rsc>(std::filesystem::path("PACK:/text/koro.txt")), koro_sptr);
+        ASSERT_EQ(rmanager.get_shared<memory_rsc>(std::string_view("PACK:/text/koro.txt")), koro_sptr);
+        ASSERT_EQ(rmanager.get_shared<memory_rsc>("PACK:/text/koro.txt"_rsc), koro_sptr);
+        ASSERT_EQ(rmanager.store<memory_rsc>().find("PACK:/text/koro.txt"), koro_sptr);
+        ASSERT_EQ(rmanager.get<stream_text_rsc>("PACK:/text/tiki.txt").contents, tiki_contents());
+        ASSERT_EQ(rmanager.number_of_resources<memory_rsc>(), 1);
+    }
+    std::filesystem::remove(pack_path);
+}
+
+TEST(resource_manager_tests, get_shared__missing_pack_entry__filesystem_error)
+{
+    const std::filesystem::path pack_path = write_text_pack("rsce_resource_manager_tests_missing.pack");
+    {
+        vlfs::virtual_filesystem vlfs = create_vlfs();
+        rsce::resource_manager rmanager(vlfs);
+        rmanager.mount_pack("PACK", pack_path);
+        ASSERT_THROW(rmanager.get_shared<memory_rsc>("PACK:/text/missing.txt"), std::filesystem::filesystem_error);
+        ASSERT_EQ(rmanager.get_shared<memory_rsc>("PACK:/text/missing.txt", std::nothrow), nullptr);
+        ASSERT_EQ(rmanager.get_shared<memory_rsc>("PACK:/text/invalid.txt", std::nothrow), nullptr);
+        ASSERT_THROW(rmanager.get_shared<text>("PACK:/text/koro.txt"), std::filesystem::filesystem_error);
+#ifdef ARBA_RSCE_HAS_EXPECTED
+        auto result = rmanager.try_get_shared<memory_rsc>("PACK:/text/missing.txt");
+        ASSERT_FALSE(result);
+        ASSERT_EQ(result.error().code, std::errc::no_such_file_or_directory);
+        ASSERT_EQ(rmanager.try_get_shared<memory_rsc>("PACK:/text/koro.txt").value()->contents, koro_contents());
+#endif
+    }
+    std::filesystem::remove(pack_path);
+}
+
+TEST(resource_manager_tests, load__pack_path__pack_path_not_supported_error)
+{
+    const std::filesystem::path pack_path = write_text_pack("rsce_resource_manager_tests_load.pack");
+    {
+        vlfs::virtual_filesystem vlfs = create_vlfs();
+        rsce::resource_manager rmanager(vlfs);
+        rmanager.mount_pack("PACK", pack_path);
+        const std::filesystem::path rsc_path = "PACK:/text/koro.txt";
+        ASSERT_TRUE(rejects_pack_path([&] { rmanager.load<memory_rsc>(rsc_path); }));
+        ASSERT_TRUE(rejects_pack_path([&] { rmanager.load<memory_rsc>(std::filesystem::path(rsc_path)); }));
+        ASSERT_EQ(rmanager.load<memory_rsc>(rsc_path, std::nothrow), nullptr);
+        ASSERT_EQ(rmanager.load<memory_rsc>(std::filesystem::path(rsc_path), std::nothrow), nullptr);
+        ASSERT_EQ(rmanager.number_of_resources<memory_rsc>(), 0);
+    }
+    std::filesystem::remove(pack_path);
+}
+
+TEST(resource_manager_tests, get_shared_async__pack_path__pack_path_not_supported_error)
+{
+    const std::filesystem::path pack_path = write_text_pack("rsce_resource_manager_tests_get_shared_async.pack");
+    {
+        vlfs::virtual_filesystem vlfs = create_vlfs();
+        rsce::resource_manager rmanager(vlfs);
+        rmanager.mount_pack("PACK", pack_path);
+        const std::filesystem::path rsc_path = "PACK:/text/koro.txt";
+        ASSERT_TRUE(rejects_pack_path([&] { rmanager.get_shared_async<memory_rsc>(rsc_path); }));
+        ASSERT_EQ(rmanager.number_of_resources<memory_rsc>(), 0);
+    }
+    std::filesystem::remove(pack_path);
+}
+
+TEST(resource_manager_tests, load_async__pack_path__pack_path_not_supported_error)
+{
+    const std::filesystem::path pack_path = write_text_pack("rsce_resource_manager_tests_load_async.pack");
+    {
+        vlfs::virtual_filesystem vlfs = create_vlfs();
+        rsce::resource_manager rmanager(vlfs);
+        rmanager.mount_pack("PACK", pack_path);
+        const std::filesystem::path rsc_path = "PACK:/text/koro.txt";
+        ASSERT_TRUE(rejects_pack_path([&] { rmanager.load_async<memory_rsc>(rsc_path); }));
+        ASSERT_EQ(rmanager.number_of_resources<memory_rsc>(), 0);
+    }
+    std::filesystem::remove(pack_path);
+}
+
+TEST(resource_manager_tests, preload__pack_path__pack_path_not_supported_error)
+{
+    const std::filesystem::path pack_path = write_text_pack("rsce_resource_manager_tests_preload.pack");
+    {
+        vlfs::virtual_filesystem vlfs = create_vlfs();
+        rsce::resource_manager rmanager(vlfs);
+        rmanager.mount_pack("PACK", pack_path);
+        const std::filesystem::path rsc_path = "PACK:/text/koro.txt";
+        const std::array rsc_paths{ textdir() / "koro.txt", rsc_path };
+        ASSERT_TRUE(rejects_pack_path([&] { rmanager.preload<memory_rsc>(rsc_paths); }));
+        const std::array entries{ rsce::resource_preload_entry::make<memory_rsc>(textdir() / "tiki.txt"),
+                                  rsce::resource_preload_entry::make<memory_rsc>(rsc_path) };
+        ASSERT_TRUE(rejects_pack_path([&] { rmanager.preload(entries); }));
+        ASSERT_EQ(rmanager.number_of_resources<memory_rsc>(), 0);
+    }
+    std::filesystem::remove(pack_path);
+}
+
+TEST(resource_manager_tests, intern__pack_path__pack_path_not_supported_error)
+{
+    const std::filesystem::path pack_path = write_text_pack("rsce_resource_manager_tests_intern.pack");
+    {
+        vlfs::virtual_filesystem vlfs = create_vlfs();
+        rsce::resource_manager rmanager(vlfs);
+        rmanager.mount_pack("PACK", pack_path);
+        const std::filesystem::path rsc_path = "PACK:/text/koro.txt";
+        ASSERT_TRUE(rejects_pack_path([&] { rmanager.intern<memory_rsc>(rsc_path); }));
+        ASSERT_EQ(rmanager.number_of_resources<memory_rsc>(), 0);
+    }
+    std::filesystem::remove(pack_path);
+}
+
+TEST(resource_manager_tests, get_handle__pack_path__pack_path_not_supported_error)
+{
+    const std::filesystem::path pack_path = write_text_pack("rsce_resource_manager_tests_get_handle.pack");
+    {
+        vlfs::virtual_filesystem vlfs = create_vlfs();
+        rsce::resource_manager rmanager(vlfs);
+        rmanager.mount_pack("PACK", pack_path);
+        const std::filesystem::path rsc_path = "PACK:/text/koro.txt";
+        ASSERT_TRUE(rejects_pack_path([&] { rmanager.get_handle<memory_rsc>(rsc_path); }));
+        ASSERT_EQ(rmanager.number_of_resources<memory_rsc>(), 0);
+    }
+    std::filesystem::remove(pack_path);
+}
+
+TEST(resource_manager_tests, insert__pack_path__pack_path_not_supported_error)
+{
+    const std::filesystem::path pack_path = write_text_pack("rsce_resource_manager_tests_insert.pack");
+    {
+        vlfs::virtual_filesystem vlfs = create_vlfs();
+        rsce::resource_manager rmanager(vlfs);
+        rmanager.mount_pack("PACK", pack_path);
+        const std::filesystem::path rsc_path = "PACK:/text/koro.txt";
+        std::shared_ptr<memory_rsc> rsc_sptr = std::make_shared<memory_rsc>();
+        ASSERT_TRUE(rejects_pack_path([&] { rmanager.insert(rsc_path, rsc_sptr); }));
+        ASSERT_TRUE(rejects_pack_path([&] { rmanager.insert(std::filesystem::path(rsc_path), rsc_sptr); }));
+        ASSERT_EQ(rmanager.number_of_resources<memory_rsc>(), 0);
+    }
+    std::filesystem::remove(pack_path);
+}
+
+TEST(resource_manager_tests, set__pack_path__pack_path_not_supported_error)
+{
+    const std::filesystem::path pack_path = write_text_pack("rsce_resource_manager_tests_set.pack");
+    {
+        vlfs::virtual_filesystem vlfs = create_vlfs();
+        rsce::resource_manager rmanager(vlfs);
+        rmanager.mount_pack("PACK", pack_path);
+        const std::filesystem::path rsc_path = "PACK:/text/koro.txt";
+        std::shared_ptr<memory_rsc> rsc_sptr = std::make_shared<memory_rsc>();
+        ASSERT_TRUE(rejects_pack_path([&] { rmanager.set(rsc_path, rsc_sptr); }));
+        ASSERT_TRUE(rejects_pack_path([&] { rmanager.set(std::filesystem::path(rsc_path), rsc_sptr); }));
+        ASSERT_EQ(rmanager.number_of_resources<memory_rsc>(), 0);
+    }
+    std::filesystem::remove(pack_path);
+}
+
+TEST(resource_manager_tests, remove__pack_path__pack_path_not_supported_error)
+{
+    const std::filesystem::path pack_path = write_text_pack("rsce_resource_manager_tests_remove.pack");
+    {
+        vlfs::virtual_filesystem vlfs = create_vlfs();
+        rsce::resource_manager rmanager(vlfs);
+        rmanager.mount_pack("PACK", pack_path);
+        const std::filesystem::path rsc_path = "PACK:/text/koro.txt";
+        ASSERT_TRUE(rejects_pack_path([&] { rmanager.remove<memory_rsc>(rsc_path); }));
+        ASSERT_TRUE(rejects_pack_path([&] { rmanager.remove<memory_rsc>(std::filesystem::path(rsc_path)); }));
+        ASSERT_EQ(rmanager.number_of_resources<memory_rsc>(), 0);
+    }
+    std::filesystem::remove(pack_path);
+}
+
+TEST(resource_manager_tests, mount_pack__vlfs_root_name__pack_hides_vlfs_root)
+{
+    rsce::resource_pack_builder builder;
+    builder.add("koro.txt", as_bytes("Packed koro"));
+    const std::filesystem::path pack_path =
+        std::filesystem::temp_directory_path() / "rsce_resource_manager_tests_hide.pack";
+    builder.write(pack_path);
+
+    {
+        vlfs::virtual_filesystem vlfs = create_vlfs();
+        rsce::resource_manager rmanager(vlfs);
+        rmanager.mount_pack("TEXT", std::make_shared<const rsce::resource_pack>(pack_path));
+        ASSERT_EQ(rmanager.get<memory_rsc>("TEXT:/koro.txt").contents, "Packed koro");
+        ASSERT_EQ(rmanager.get<memory_rsc>(textdir() / "koro.txt").contents, koro_contents());
+        ASSERT_EQ(rmanager.number_of_resources<memory_rsc>(), 2);
+    }
+    std::filesystem::remove(pack_path);
+}
+
+TEST(resource_manager_tests, mount_pack__after_lookup__logic_error)
+{
+    const std::filesystem::path pack_path = write_text_pack("rsce_resource_manager_tests_late_mount.pack");
+    {
+        vlfs::virtual_filesystem vlfs = create_vlfs();
+        rsce::resource_manager rmanager(vlfs);
+        rmanager.mount_pack("PACK", pack_path);
+        // Replaced before any lookup.
+        rmanager.mount_pack("PACK", pack_path);
+        ASSERT_EQ(rmanager.get<memory_rsc>("PACK:/text/koro.txt").contents, koro_contents());
+        ASSERT_THROW(rmanager.mount_pack("PACK", pack_path), std::logic_error);
+        ASSERT_THROW(rmanager.mount_pack("OTHER", pack_path), std::logic_error);
+        ASSERT_EQ(rmanager.get<memory_rsc>("PACK:/text/koro.txt").contents, koro_contents());
+    }
+    std::filesystem::remove(pack_path);
+}
@@ -0,0 +1,243 @@
+#include <arba/rsce/resource_pack.hpp>
+
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace
+{
+std::vector<std::byte> as_bytes(std::string_view contents)
+{
+    const std::byte* data = reinterpret_cast<const std::byte*>(contents.data());
+    return std::vector<std::byte>(data, data + contents.size());
+}
+
+std::string_view as_string_view(std::span<const std::byte> bytes)
+{
+    return std::string_view(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+}
+
+std::filesystem::path write_test_pack(std::string_view name)
+{
+    rsce::resource_pack_builder builder;
+    builder.add("ui/font.ttf", as_bytes("font contents"));
+    builder.add("text/koro.txt", as_bytes("koro koro\nkoro"));
+    builder.add("empty.bin", {});
+    builder.add("text/tiki.txt", as_bytes("Tiki Tiki tiki."));
+    std::filesystem::path fpath = std::filesystem::temp_directory_path() / name;
+    builder.write(fpath);
+    return fpath;
+}
+} // namespace
+
+// Unit tests:
+
+TEST(resource_pack_tests, find__existing_entries__contents)
+{
+    std::filesystem::path fpath = write_test_pack("rsce_resource_pack_tests_find.pack");
+    {
+        rsce::resource_pack pack(fpath);
+        ASSERT_EQ(pack.path(), fpath);
+        ASSERT_EQ(pack.size(), 4);
+        ASSERT_EQ(as_string_view(pack.find("ui/font.ttf").value()), "font contents");
+        ASSERT_EQ(as_string_view(pack.find("text/koro.txt").value()), "koro koro\nkoro");
+        ASSERT_EQ(as_string_view(pack.at("text/tiki.txt")), "Tiki Tiki tiki.");
+        ASSERT_TRUE(pack.find("empty.bin").value().empty());
+    }
+    std::filesystem::remove(fpath);
+}
+
+TEST(resource_pack_tests, find__missing_entries__nullopt)
+{
+    std::filesystem::path fpath = write_test_pack("rsce_resource_pack_tests_missing.pack");
+    {
+        rsce::resource_pack pack(fpath);
+        ASSERT_FALSE(pack.find("ui/missing.ttf"));
+        ASSERT_FALSE(pack.find("text"));
+        ASSERT_FALSE(pack.find("/ui/font.ttf"));
+        ASSERT_FALSE(pack.find(""));
+        ASSERT_THROW(pack.at("zzz.txt"), std::filesystem::filesystem_error);
+    }
+    std::filesystem::remove(fpath);
+}
+
+TEST(resource_pack_tests, entry_path__all_entries__sorted_and_aligned)
+{
+    std::filesystem::path fpath = write_test_pack("rsce_resource_pack_tests_sorted.pack");
+    {
+        rsce::resource_pack pack(fpath);
+        ASSERT_EQ(pack.entry_path(0), "empty.bin");
+        ASSERT_EQ(pack.entry_path(1), "text/koro.txt");
+        ASSERT_EQ(pack.entry_path(2), "text/tiki.txt");
+        ASSERT_EQ(pack.entry_path(3), "ui/font.ttf");
+        for (std::size_t index = 0; index < pack.size(); ++index)
+            ASSERT_EQ(reinterpret_cast<std::uintptr_t>(pack.entry_bytes(index).data()) % 16, 0);
+    }
+    std::filesystem::remove(fpath);
+}
+
+TEST(resource_pack_tests, write__entries_added_in_any_order__same_file)
+{
+    const std::filesystem::path fpath_1 = std::filesystem::temp_directory_path() / "rsce_resource_pack_tests_1.pack";
+    const std::filesystem::path fpath_2 = std::filesystem::temp_directory_path() / "rsce_resource_pack_tests_2.pack";
+    rsce::resource_pack_builder builder_1;
+    builder_1.add("b.txt", as_bytes("b"));
+    builder_1.add("a.txt", as_bytes("a"));
+    builder_1.write(fpath_1);
+    rsce::resource_pack_builder builder_2;
+    builder_2.add("a.txt", as_bytes("a"));
+    builder_2.add("b.txt", as_bytes("old b"));
+    builder_2.add("b.txt", as_bytes("b"));
+    builder_2.write(fpath_2);
+
+    auto read_file = [](const std::filesystem::path& fpath) {
+        std::ifstream stream(fpath, std::ios::binary);
+        return std::string(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+    };
+    ASSERT_EQ(read_file(fpath_1), read_file(fpath_2));
+    std::filesystem::remove(fpath_1);
+    std::filesystem::remove(fpath_2);
+}
+
+TEST(resource_pack_tests, add__invalid_entry_path__invalid_argument)
+{
+    rsce::resource_pack_builder builder;
+    ASSERT_THROW(builder.add("", {}), std::invalid_argument);
+    ASSERT_THROW(builder.add("/ui/font.ttf", {}), std::invalid_argument);
+    ASSERT_THROW(builder.add("ui//font.ttf", {}), std::invalid_argument);
+    ASSERT_THROW(builder.add("ui/../font.ttf", {}), std::invalid_argument);
+    ASSERT_THROW(builder.add("ui\\font.ttf", {}), std::invalid_argument);
+    ASSERT_EQ(builder.size(), 0);
+}
+
+TEST(resource_pack_tests, constructor__not_a_pack__filesystem_error)
+{
+    const std::filesystem::path fpath = std::filesystem::temp_directory_path() / "rsce_resource_pack_tests_bad.pack";
+    std::ofstream(fpath, std::ios::binary) << "RSCEPACK but truncated";
+    ASSERT_THROW(rsce::resource_pack pack(fpath), std::filesystem::filesystem_error);
+    std::ofstream(fpath, std::ios::binary) << "not a resource pack, whatever its size is";
+    ASSERT_THROW(rsce::resource_pack pack(fpath), std::filesystem::filesystem_error);
+    std::filesystem::remove(fpath);
+    ASSERT_THROW(rsce::resource_pack pack(fpath), std::filesystem::filesystem_error);
+}
+
+TEST(resource_pack_tests, constructor__misaligned_entry__filesystem_error)
+{
+    const std::filesystem::path fpath = write_test_pack("rsce_resource_pack_tests_misaligned.pack");
+    std::vector<char> contents;
+    {
+        std::ifstream stream(fpath, std::ios::binary);
+        contents.assign(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+    }
+    // The offset of the first entry, still in the file but no longer a multiple of the blob alignment.
+    ++contents[rsce::resource_pack::header_size];
+    std::ofstream(fpath, std::ios::binary).write(contents.data(), static_cast<std::streamsize>(contents.size()));
+    ASSERT_THROW(rsce::resource_pack pack(fpath), std::filesystem::filesystem_error);
+    std::filesystem::remove(fpath);
+}
+
+TEST(resource_pack_tests, write__deduplication__identical_contents_share_a_blob)
+{
+    const std::filesystem::path fpath = std::filesystem::temp_directory_path() / "rsce_resource_pack_tests_dedup.pack";
+    rsce::resource_pack_builder builder;
+    builder.set_deduplication(true);
+    builder.add("a.txt", as_bytes("same contents"));
+    builder.add("b.txt", as_bytes("other contents"));
+    builder.add("c.txt", as_bytes("same contents"));
+    builder.add("d.txt", as_bytes("same_contents"));
+    const rsce::resource_pack_builder::write_summary summary = builder.write(fpath);
+    ASSERT_EQ(summary.number_of_entries, 4);
+    ASSERT_EQ(summary.number_of_blobs, 3);
+    ASSERT_EQ(summary.file_size, std::filesystem::file_size(fpath));
+    {
+        rsce::resource_pack pack(fpath);
+        ASSERT_EQ(pack.at("a.txt").data(), pack.at("c.txt").data());
+        ASSERT_EQ(as_string_view(pack.at("c.txt")), "same contents");
+        ASSERT_EQ(as_string_view(pack.at("b.txt")), "other contents");
+        ASSERT_EQ(as_string_view(pack.at("d.txt")), "same_contents");
+    }
+    std::filesystem::remove(fpath);
+}
+
+TEST(resource_pack_tests, add_directory__directory_tree__same_pack_whatever_the_number_of_threads)
+{
+    const std::filesystem::path dpath = std::filesystem::temp_directory_path() / "rsce_resource_pack_tests_dir";
+    std::filesystem::remove_all(dpath);
+    std::filesystem::create_directories(dpath / "sub" / "subsub");
+    std::ofstream(dpath / "root.txt", std::ios::binary) << "root";
+    std::ofstream(dpath / "sub" / "a.txt", std::ios::binary) << "a";
+    std::ofstream(dpath / "sub" / "subsub" / "b.txt", std::ios::binary) << "root";
+    std::ofstream(dpath / "sub" / "empty.txt", std::ios::binary);
+
+    auto write_pack = [&](std::size_t number_of_threads, const std::filesystem::path& fpath) {
+        rsce::resource_pack_builder builder;
+        builder.set_deduplication(true);
+        builder.set_number_of_threads(number_of_threads);
+        EXPECT_EQ(builder.add_directory(dpath, "assets"), 4);
+        builder.write(fpath);
+        std::ifstream stream(fpath, std::ios::binary);
+        return std::string(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+    };
+    const std::filesystem::path fpath = std::filesystem::temp_directory_path() / "rsce_resource_pack_tests_dir.pack";
+    const std::string single_thread_pack = write_pack(1, fpath);
+    ASSERT_EQ(write_pack(4, fpath), single_thread_pack);
+    {
+        rsce::resource_pack pack(fpath);
+        ASSERT_EQ(pack.size(), 4);
+        ASSERT_EQ(as_string_view(pack.at("assets/root.txt")), "root");
+        ASSERT_EQ(as_string_view(pack.at("assets/sub/a.txt")), "a");
+        ASSERT_EQ(pack.at("assets/sub/subsub/b.txt").data(), pack.at("assets/root.txt").data());
+        ASSERT_TRUE(pack.at("assets/sub/empty.txt").empty());
+    }
+    std::filesystem::remove(fpath);
+    std::filesystem::remove_all(dpath);
+}
+
+TEST(resource_pack_tests, add_directory__pack_in_the_directory__pack_skipped)
+{
+    const std::filesystem::path dpath = std::filesystem::temp_directory_path() / "rsce_resource_pack_tests_self";
+    std::filesystem::remove_all(dpath);
+    std::filesystem::create_directories(dpath / "sub");
+    std::ofstream(dpath / "root.txt", std::ios::binary) << "root";
+    std::ofstream(dpath / "sub" / "self.pack", std::ios::binary) << "previous pack";
+    std::ofstream(dpath / "sub" / "self.pack.tmp", std::ios::binary) << "interrupted pack";
+    std::ofstream(dpath / "self.pack", std::ios::binary) << "not the excluded pack";
+
+    const std::filesystem::path fpath = dpath / "sub" / "self.pack";
+    rsce::resource_pack_builder builder;
+    ASSERT_EQ(builder.add_directory(dpath, {}, fpath), 2);
+    builder.write(fpath);
+    {
+        rsce::resource_pack pack(fpath);
+        ASSERT_EQ(pack.size(), 2);
+        ASSERT_EQ(as_string_view(pack.at("root.txt")), "root");
+        ASSERT_EQ(as_string_view(pack.at("self.pack")), "not the excluded pack");
+    }
+    std::filesystem::remove_all(dpath);
+}
+
+TEST(resource_pack_tests, write__missing_file__previous_pack_kept)
+{
+    const std::filesystem::path fpath = write_test_pack("rsce_resource_pack_tests_kept.pack");
+    const std::uintmax_t file_size = std::filesystem::file_size(fpath);
+    rsce::resource_pack_builder builder;
+    builder.add("a.txt", as_bytes("contents"));
+    builder.add_file("missing.txt", std::filesystem::temp_directory_path() / "rsce_resource_pack_tests_missing.txt");
+    ASSERT_THROW(builder.write(fpath), std::filesystem::filesystem_error);
+    ASSERT_EQ(std::filesystem::file_size(fpath), file_size);
+    ASSERT_FALSE(std::filesystem::exists(std::filesystem::path(fpath) += ".tmp"));
+    {
+        rsce::resource_pack pack(fpath);
+        ASSERT_EQ(as_string_view(pack.at("ui/font.ttf")), "font contents");
+    }
+    std::filesystem::remove(fpath);
+}
@@ -1,3 +1,4 @@
+#include "resources/memory_rsc.hpp"
 #include "resources/resources_helper.hpp"
 #include "resources/story.hpp"
 #include "resources/story_mngr.hpp"
@@ -8,19 +9,69 @@
 #include "resources/text.hpp"
 #include "resources/text_mngr.hpp"
 #include <arba/rsce/basic_resource_manager.hpp>
+#include <arba/rsce/loader_thread_pool.hpp>
+#include <arba/rsce/mapped_resource.hpp>
 #include <arba/rsce/resource_store.hpp>
 
 #include <gtest/gtest.h>
 
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <future>
+#include <latch>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#if defined(__linux__) && defined(__GLIBCXX__)
+#include <dlfcn.h>
+
+#define RSCE_TESTS_COUNT_EXCEPTIONS
+
+// Counts the exceptions built (thrown or stored in an exception_ptr) by the calling thread while counting is true.
+thread_local bool counting_exceptions = false;
+thread_local int number_of_exceptions = 0;
+
+extern "C" void* __cxa_allocate_exception(std::size_t size) noexcept
+{
+    using allocate_exception_function = void* (*)(std::size_t) noexcept;
+    static const allocate_exception_function allocate_exception =
+        reinterpret_cast<allocate_exception_function>(dlsym(RTLD_NEXT, "__cxa_allocate_exception"));
+    if (counting_exceptions)
+        ++number_of_exceptions;
+    return allocate_exception(size);
+}
+#endif
+
 static_assert(rsce::traits::is_loadable_resource_v<text>);
 static_assert(rsce::traits::is_loadable_resource_v<text_mngr, rsce::basic_resource_manager>);
 static_assert(rsce::traits::is_loadable_resource_v<stream_text_rsc>);
 static_assert(rsce::traits::is_loadable_resource_v<stream_text_rsc_mngr, rsce::basic_resource_manager>);
 static_assert(rsce::traits::is_loadable_resource_v<stream_binary_rsc>);
 static_assert(rsce::traits::is_loadable_resource_v<stream_binary_rsc_mngr, rsce::basic_resource_manager>);
+static_assert(rsce::traits::is_loadable_resource_v<memory_rsc>);
+static_assert(rsce::traits::is_loadable_resource_v<memory_rsc_mngr, rsce::basic_resource_manager>);
 
 using text_sptr = rsce::resource_store<text>::resource_sptr;
 using text_mngr_sptr = rsce::resource_store<text_mngr>::resource_sptr;
+using read_mostly_text_store = rsce::default_resource_store<text, rsce::read_mostly_resource_store_policy>;
+using sharded_text_store = rsce::default_resource_store<text, rsce::sharded_resource_store_policy<8>>;
+using lexical_text_store = rsce::default_resource_store<text, rsce::lexical_resource_store_policy>;
+using flat_text_store = rsce::default_resource_store<text, rsce::flat_resource_store_policy>;
+using thread_cached_text_store = rsce::default_resource_store<text, rsce::thread_cached_resource_store_policy<8>>;
+using negative_cached_text_store = rsce::default_resource_store<text, rsce::negative_cached_resource_store_policy<>>;
+
+struct text_root
+{
+    static const std::filesystem::path& root() { return textdir(); }
+};
+
+struct rooted_lexical_policy : public rsce::default_resource_store_policy
+{
+    using path_normalizer = rsce::lexical_path_normalizer<text_root>;
+};
 
 namespace rsce
 {
@@ -28,8 +79,95 @@ template class default_resource_store<text>;
 template class default_resource_store<story>;
 template class default_resource_store<stream_text_rsc>;
 template class default_resource_store<stream_binary_rsc>;
+template class default_resource_store<memory_rsc>;
+template class default_resource_store<mapped_blob>;
+template class default_resource_store<text, read_mostly_resource_store_policy>;
+template class default_resource_store<text, sharded_resource_store_policy<8>>;
+template class default_resource_store<text, lexical_resource_store_policy>;
+template class default_resource_store<text, flat_resource_store_policy>;
+template class default_resource_store<text, thread_cached_resource_store_policy<8>>;
+template class default_resource_store<text, negative_cached_resource_store_policy<>>;
 } // namespace rsce
 
+class mapped_stream_binary_rsc : public stream_binary_rsc
+{
+};
+
+class mapped_stream_text_rsc_mngr : public stream_text_rsc_mngr
+{
+};
+
+namespace rsce::traits
+{
+template <>
+inline constexpr stream_source stream_source_v<mapped_stream_binary_rsc> = stream_source::file_mapping;
+template <>
+inline constexpr stream_source stream_source_v<mapped_stream_text_rsc_mngr> = stream_source::file_mapping;
+} // namespace rsce::traits
+
+class counted_text : public text
+{
+public:
+    inline static std::atomic_int number_of_loads = 0;
+
+    bool load_from_file(const std::filesystem::path& fpath)
+    {
+        ++number_of_loads;
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        return text::load_from_file(fpath);
+    }
+};
+
+// Lets a test block the next load of a gated_text until it releases it.
+struct load_gate
+{
+    std::latch started{ 1 };
+    std::promise<void> release;
+    std::shared_future<void> released = release.get_future().share();
+};
+
+class gated_text : public text
+{
+public:
+    inline static std::atomic_int number_of_loads = 0;
+    // Armed by a test, and disarmed by the load it blocks.
+    inline static std::atomic<load_gate*> gate = nullptr;
+
+    bool load_from_file(const std::filesystem::path& fpath)
+    {
+        ++number_of_loads;
+        if (load_gate* next_gate = gate.exchange(nullptr))
+        {
+            next_gate->started.count_down();
+            next_gate->released.wait();
+        }
+        return text::load_from_file(fpath);
+    }
+};
+
+class failing_text : public text
+{
+public:
+    inline static std::atomic_int number_of_loads = 0;
+
+    bool load_from_file(const std::filesystem::path&)
+    {
+        ++number_of_loads;
+        return false;
+    }
+};
+
+class coded_text : public text
+{
+public:
+    std::error_code load_from_file(const std::filesystem::path& fpath)
+    {
+        if (!text::load_from_file(fpath))
+            return std::make_error_code(std::errc::invalid_argument);
+        return std::error_code();
+    }
+};
+
 // Unit tests:
 
 TEST(resource_store_tests, constructor__no_arg__no_error)
@@ -102,6 +240,52 @@ TEST(resource_store_tests, get_shared__stream_binary_rsc_file_exists__no_excepti
     }
 }
 
+TEST(resource_store_tests, get_shared__stream_rsc_file_mapping__same_contents)
+{
+    std::filesystem::path rsc = textdir();
+    rsce::basic_resource_manager rmanager;
+
+    rsce::resource_store<mapped_stream_binary_rsc> binary_store;
+    ASSERT_EQ(binary_store.get_shared(rsc / "tiki.txt")->contents, tiki_contents());
+    ASSERT_THROW(binary_store.get_shared(rsc / "invalid.txt"), std::runtime_error);
+    rsce::resource_store<mapped_stream_text_rsc_mngr> text_store;
+    ASSERT_EQ(text_store.get_shared(rsc / "koro.txt", rmanager)->contents, koro_contents());
+}
+
+TEST(resource_store_tests, get_shared__memory_rsc_file_exists__loaded_from_memory)
+{
+    std::filesystem::path rsc = textdir();
+
+    rsce::resource_store<memory_rsc> text_store;
+    std::shared_ptr tiki_sptr = text_store.get_shared(rsc / "tiki.txt");
+    ASSERT_EQ(tiki_sptr->contents, tiki_contents());
+    ASSERT_THROW(text_store.get_shared(rsc / "invalid.txt"), std::runtime_error);
+    ASSERT_THROW(text_store.get_shared(rsc / "not_found.txt"), std::filesystem::filesystem_error);
+    ASSERT_EQ(text_store.size(), 1);
+}
+
+TEST(resource_store_tests, get_shared__mapped_blob__mapping_owned_by_resource)
+{
+    std::filesystem::path rsc = textdir();
+
+    rsce::resource_store<rsce::mapped_blob> blob_store;
+    std::shared_ptr<rsce::mapped_blob> koro_sptr = blob_store.get_shared(rsc / "koro.txt");
+    ASSERT_EQ(blob_store.get_shared(rsc / "koro.txt"), koro_sptr);
+    blob_store.clear();
+    ASSERT_EQ(std::string_view(reinterpret_cast<const char*>(koro_sptr->data()), koro_sptr->size()),
+              koro_contents());
+}
+
+TEST(resource_store_tests, get_shared__memory_rsc_mngr_file_exists__loaded_from_memory)
+{
+    std::filesystem::path rsc = textdir();
+    rsce::basic_resource_manager rmanager;
+
+    rsce::resource_store<memory_rsc_mngr> text_store;
+    std::shared_ptr koro_sptr = text_store.get_shared(rsc / "koro.txt", rmanager);
+    ASSERT_EQ(koro_sptr->contents, koro_contents());
+}
+
 TEST(resource_store_tests, get_shared__stream_text_rsc_mngr_file_exists__no_exception)
 {
     std::filesystem::path rsc = textdir();
@@ -271,6 +455,18 @@ TEST(resource_store_tests, load__resource_file_does_not_exist__not_found_excepti
     }
 }
 
+TEST(resource_store_tests, load__nothrow_resource_file_does_not_exist__nullptr)
+{
+    std::filesystem::path rsc = textdir();
+    rsce::resource_store<text> text_store;
+
+    ASSERT_EQ(text_store.load(rsc / "not_found.txt", std::nothrow), nullptr);
+    text_sptr koro_sptr = text_store.load(rsc / "koro.txt", std::nothrow);
+    ASSERT_NE(koro_sptr, nullptr);
+    ASSERT_EQ(koro_sptr->contents, koro_contents());
+    ASSERT_EQ(text_store.size(), 1);
+}
+
 TEST(resource_store_tests, load__resource_mngr_file_exists__expect_no_exception)
 {
     std::filesystem::path rsc = textdir();
@@ -363,3 +559,673 @@ TEST(resource_store_tests, remove__rsc_path__no_error)
     text_store.remove(rsc / "tiki.txt");
     ASSERT_EQ(text_store.size(), 0);
 }
+
+TEST(resource_store_tests, get_shared__concurrent_calls_same_file__loaded_once)
+{
+    std::filesystem::path rsc = textdir();
+
+    rsce::resource_store<counted_text> text_store;
+    counted_text::number_of_loads = 0;
+    std::vector<std::shared_ptr<counted_text>> rsc_sptrs(8);
+    std::vector<std::jthread> threads;
+    for (std::size_t i = 0; i < rsc_sptrs.size(); ++i)
+        threads.emplace_back([&, i]() { rsc_sptrs[i] = text_store.get_shared(rsc / "koro.txt"); });
+    threads.clear();
+    ASSERT_EQ(counted_text::number_of_loads, 1);
+    ASSERT_EQ(text_store.size(), 1);
+    for (const std::shared_ptr<counted_text>& rsc_sptr : rsc_sptrs)
+        ASSERT_EQ(rsc_sptr, rsc_sptrs.front());
+}
+
+TEST(resource_store_tests, get_shared__cached_file_during_load__not_blocked)
+{
+    std::filesystem::path rsc = textdir();
+
+    rsce::resource_store<gated_text> text_store;
+    text_store.get_shared(rsc / "tiki.txt");
+    load_gate gate;
+    gated_text::gate = &gate;
+    std::jthread loading_thread([&]() { text_store.get_shared(rsc / "koro.txt"); });
+    gate.started.wait();
+    // The loading of koro.txt is blocked until the gate is released.
+    EXPECT_EQ(text_store.get_shared(rsc / "tiki.txt")->contents, tiki_contents());
+    EXPECT_EQ(text_store.size(), 1);
+    gate.release.set_value();
+    loading_thread.join();
+    ASSERT_EQ(text_store.size(), 2);
+}
+
+TEST(resource_store_tests, load__concurrent_join_calls_same_file__loaded_once)
+{
+    std::filesystem::path rsc = textdir();
+
+    rsce::resource_store<counted_text> text_store;
+    counted_text::number_of_loads = 0;
+    std::vector<std::shared_ptr<counted_text>> rsc_sptrs(8);
+    std::vector<std::jthread> threads;
+    for (std::size_t i = 0; i < rsc_sptrs.size(); ++i)
+        threads.emplace_back([&, i]() { rsc_sptrs[i] = text_store.load(rsc / "koro.txt", rsce::load_mode::join); });
+    threads.clear();
+    ASSERT_EQ(counted_text::number_of_loads, 1);
+    ASSERT_EQ(text_store.size(), 1);
+    for (const std::shared_ptr<counted_text>& rsc_sptr : rsc_sptrs)
+        ASSERT_EQ(rsc_sptr, rsc_sptrs.front());
+}
+
+TEST(resource_store_tests, get_shared__file_being_loaded__joins_loading)
+{
+    std::filesystem::path rsc = textdir();
+
+    rsce::resource_store<gated_text> text_store;
+    gated_text::number_of_loads = 0;
+    load_gate gate;
+    gated_text::gate = &gate;
+    std::shared_ptr<gated_text> loaded_sptr;
+    std::jthread loading_thread([&]() { loaded_sptr = text_store.load(rsc / "koro.txt"); });
+    gate.started.wait();
+    // Looked up while the loading is blocked, so either joined or, if it runs after it, found in the store.
+    std::shared_ptr<gated_text> rsc_sptr;
+    std::jthread joining_thread([&]() { rsc_sptr = text_store.get_shared(rsc / "koro.txt"); });
+    gate.release.set_value();
+    loading_thread.join();
+    joining_thread.join();
+    ASSERT_EQ(gated_text::number_of_loads, 1);
+    ASSERT_EQ(rsc_sptr, loaded_sptr);
+}
+
+TEST(resource_store_tests, load__force_during_loading__loaded_again_after_it)
+{
+    std::filesystem::path rsc = textdir();
+
+    rsce::resource_store<gated_text> text_store;
+    gated_text::number_of_loads = 0;
+    load_gate gate;
+    gated_text::gate = &gate;
+    std::shared_ptr<gated_text> stored_sptr;
+    std::jthread loading_thread([&]() { stored_sptr = text_store.get_shared(rsc / "koro.txt"); });
+    gate.started.wait();
+    // Waits for the blocked loading, then loads again.
+    std::shared_ptr<gated_text> rsc_sptr;
+    std::jthread forcing_thread([&]() { rsc_sptr = text_store.load(rsc / "koro.txt", rsce::load_mode::force); });
+    gate.release.set_value();
+    loading_thread.join();
+    forcing_thread.join();
+    ASSERT_EQ(gated_text::number_of_loads, 2);
+    ASSERT_NE(rsc_sptr, stored_sptr);
+    ASSERT_EQ(rsc_sptr->contents, stored_sptr->contents);
+    ASSERT_EQ(text_store.get_shared(rsc / "koro.txt"), stored_sptr);
+}
+
+TEST(resource_store_tests, get_shared__negative_cache_missing_file__same_exception)
+{
+    std::filesystem::path rsc = textdir();
+
+    negative_cached_text_store text_store;
+    const std::exception* first_exception = nullptr;
+    try
+    {
+        text_store.get_shared(rsc / "not_found.txt");
+        FAIL();
+    }
+    catch (const std::filesystem::filesystem_error& exception)
+    {
+        first_exception = &exception;
+    }
+    try
+    {
+        text_store.get_shared(rsc / "not_found.txt");
+        FAIL();
+    }
+    catch (const std::filesystem::filesystem_error& exception)
+    {
+        ASSERT_EQ(&exception, first_exception);
+    }
+    ASSERT_EQ(text_store.get_shared(rsc / "not_found.txt", std::nothrow), nullptr);
+}
+
+TEST(resource_store_tests, get_shared__negative_cache_file_created__found_after_forget_failures)
+{
+    std::filesystem::path fpath = std::filesystem::temp_directory_path() / "rsce_negative_cache_tests.txt";
+    std::filesystem::remove(fpath);
+
+    negative_cached_text_store text_store;
+    ASSERT_EQ(text_store.get_shared(fpath, std::nothrow), nullptr);
+    std::ofstream(fpath) << "created";
+    ASSERT_EQ(text_store.get_shared(fpath, std::nothrow), nullptr);
+    text_store.forget_failures();
+    text_sptr rsc_sptr = text_store.get_shared(fpath, std::nothrow);
+    std::filesystem::remove(fpath);
+    ASSERT_NE(rsc_sptr, nullptr);
+    ASSERT_EQ(rsc_sptr->contents, "created");
+}
+
+TEST(resource_store_tests, get_shared__negative_cache_failed_load__loaded_once)
+{
+    std::filesystem::path rsc = textdir();
+
+    rsce::default_resource_store<failing_text, rsce::negative_cached_resource_store_policy<>> text_store;
+    failing_text::number_of_loads = 0;
+    for (int i = 0; i < 3; ++i)
+        ASSERT_EQ(text_store.get_shared(rsc / "../text/koro.txt", std::nothrow), nullptr);
+    ASSERT_THROW(text_store.get_shared(rsc / "koro.txt"), std::runtime_error);
+    ASSERT_EQ(failing_text::number_of_loads, 1);
+    ASSERT_THROW(text_store.load(rsc / "koro.txt"), std::runtime_error);
+    ASSERT_EQ(failing_text::number_of_loads, 2);
+}
+
+TEST(resource_store_tests, get_shared__negative_cache_failure_expired__loaded_again)
+{
+    std::filesystem::path rsc = textdir();
+
+    constexpr std::chrono::milliseconds ttl(50);
+    rsce::default_resource_store<failing_text, rsce::negative_cached_resource_store_policy<ttl.count()>> text_store;
+    failing_text::number_of_loads = 0;
+    // The failure expires between ttl after before_failure and ttl after after_failure.
+    const std::chrono::steady_clock::time_point before_failure = std::chrono::steady_clock::now();
+    ASSERT_EQ(text_store.get_shared(rsc / "koro.txt", std::nothrow), nullptr);
+    const std::chrono::steady_clock::time_point after_failure = std::chrono::steady_clock::now();
+    ASSERT_EQ(failing_text::number_of_loads, 1);
+    ASSERT_EQ(text_store.get_shared(rsc / "koro.txt", std::nothrow), nullptr);
+    if (std::chrono::steady_clock::now() < before_failure + ttl)
+    {
+        ASSERT_EQ(failing_text::number_of_loads, 1);
+    }
+    std::this_thread::sleep_until(after_failure + ttl + std::chrono::milliseconds(1));
+    const int number_of_loads = failing_text::number_of_loads;
+    ASSERT_EQ(text_store.get_shared(rsc / "koro.txt", std::nothrow), nullptr);
+    ASSERT_EQ(failing_text::number_of_loads, number_of_loads + 1);
+}
+
+TEST(resource_store_tests, get_shared__no_negative_cache_failed_load__loaded_each_time)
+{
+    std::filesystem::path rsc = textdir();
+
+    rsce::resource_store<failing_text> text_store;
+    failing_text::number_of_loads = 0;
+    ASSERT_EQ(text_store.get_shared(rsc / "koro.txt", std::nothrow), nullptr);
+    ASSERT_EQ(text_store.get_shared(rsc / "koro.txt", std::nothrow), nullptr);
+    ASSERT_EQ(failing_text::number_of_loads, 2);
+}
+
+TEST(resource_store_tests, get_shared__load_from_file_returns_error_code__not_loaded_exception)
+{
+    std::filesystem::path rsc = textdir();
+
+    rsce::resource_store<coded_text> text_store;
+    ASSERT_EQ(text_store.get_shared(rsc / "koro.txt")->contents, koro_contents());
+    ASSERT_THROW(text_store.get_shared(rsc / "invalid.txt"), std::runtime_error);
+}
+
+TEST(resource_store_tests, get_shared__nothrow_failed_load_not_cached__no_exception_built)
+{
+#ifdef RSCE_TESTS_COUNT_EXCEPTIONS
+    std::filesystem::path rsc = textdir();
+
+    rsce::resource_store<failing_text> text_store;
+    number_of_exceptions = 0;
+    counting_exceptions = true;
+    std::shared_ptr<failing_text> rsc_sptr = text_store.get_shared(rsc / "koro.txt", std::nothrow);
+    std::shared_ptr<failing_text> not_found_sptr = text_store.get_shared(rsc / "not_found.txt", std::nothrow);
+    counting_exceptions = false;
+    ASSERT_EQ(rsc_sptr, nullptr);
+    ASSERT_EQ(not_found_sptr, nullptr);
+    ASSERT_EQ(number_of_exceptions, 0);
+#else
+    GTEST_SKIP() << "Counting the built exceptions requires libstdc++ on Linux.";
+#endif
+}
+
+TEST(resource_store_tests, load_resource_from_file__load_from_file_returns_error_code__same_error)
+{
+    std::filesystem::path rsc = textdir();
+
+    std::error_code error_code;
+    ASSERT_NE(rsce::load_resource_from_file<coded_text>(rsc / "koro.txt", error_code), nullptr);
+    ASSERT_FALSE(error_code);
+    ASSERT_EQ(rsce::load_resource_from_file<coded_text>(rsc / "invalid.txt", error_code), nullptr);
+    ASSERT_EQ(error_code, std::errc::invalid_argument);
+}
+
+#ifdef ARBA_RSCE_HAS_EXPECTED
+TEST(resource_store_tests, try_get_shared__resource_file_exists__resource)
+{
+    std::filesystem::path rsc = textdir();
+
+    rsce::resource_store<text> text_store;
+    std::expected<text_sptr, rsce::load_error> result = text_store.try_get_shared(rsc / "../text/koro.txt");
+    ASSERT_TRUE(result.has_value());
+    ASSERT_EQ((*result)->contents, koro_contents());
+    ASSERT_EQ(text_store.try_get_shared(rsc / "koro.txt"), result);
+}
+
+TEST(resource_store_tests, try_get_shared__resource_file_does_not_exist__no_such_file_error)
+{
+    std::filesystem::path rsc = textdir();
+
+    rsce::resource_store<text> text_store;
+    std::expected<text_sptr, rsce::load_error> result = text_store.try_get_shared(rsc / "not_found.txt");
+    ASSERT_FALSE(result.has_value());
+    ASSERT_EQ(result.error().code, std::errc::no_such_file_or_directory);
+    ASSERT_EQ(result.error().path, rsc / "not_found.txt");
+    ASSERT_EQ(text_store.size(), 0);
+}
+
+TEST(resource_store_tests, try_get_shared__load_from_file_returns_false__resource_not_loaded_error)
+{
+    std::filesystem::path rsc = textdir();
+
+    rsce::resource_store<failing_text> text_store;
+    std::expected<std::shared_ptr<failing_text>, rsce::load_error> result = text_store.try_get_shared(rsc / "koro.txt");
+    ASSERT_FALSE(result.has_value());
+    ASSERT_EQ(result.error().code, rsce::load_errc::resource_not_loaded);
+    ASSERT_THROW(text_store.get_shared(rsc / "koro.txt"), std::runtime_error);
+}
+
+TEST(resource_store_tests, try_get_shared__failed_load_not_cached__no_exception_built)
+{
+#ifdef RSCE_TESTS_COUNT_EXCEPTIONS
+    std::filesystem::path rsc = textdir();
+
+    rsce::resource_store<failing_text> text_store;
+    number_of_exceptions = 0;
+    counting_exceptions = true;
+    std::expected<std::shared_ptr<failing_text>, rsce::load_error> result = text_store.try_get_shared(rsc / "koro.txt");
+    counting_exceptions = false;
+    ASSERT_FALSE(result.has_value());
+    ASSERT_EQ(result.error().code, rsce::load_errc::resource_not_loaded);
+    ASSERT_EQ(number_of_exceptions, 0);
+#else
+    GTEST_SKIP() << "Counting the built exceptions requires libstdc++ on Linux.";
+#endif
+}
+
+TEST(resource_store_tests, try_get_shared__load_from_file_returns_error_code__same_error)
+{
+    std::filesystem::path rsc = textdir();
+
+    rsce::resource_store<coded_text> text_store;
+    std::expected<std::shared_ptr<coded_text>, rsce::load_error> result =
+        text_store.try_get_shared(rsc / "invalid.txt");
+    ASSERT_FALSE(result.has_value());
+    ASSERT_EQ(result.error().code, std::errc::invalid_argument);
+}
+
+TEST(resource_store_tests, try_get_shared__negative_cache_failed_load__loaded_once)
+{
+    std::filesystem::path rsc = textdir();
+
+    rsce::default_resource_store<failing_text, rsce::negative_cached_resource_store_policy<>> text_store;
+    failing_text::number_of_loads = 0;
+    for (int i = 0; i < 3; ++i)
+    {
+        std::expected<std::shared_ptr<failing_text>, rsce::load_error> result =
+            text_store.try_get_shared(rsc / "koro.txt");
+        ASSERT_FALSE(result.has_value());
+        ASSERT_EQ(result.error().code, rsce::load_errc::resource_not_loaded);
+    }
+    ASSERT_THROW(text_store.get_shared(rsc / "koro.txt"), std::runtime_error);
+    ASSERT_EQ(failing_text::number_of_loads, 1);
+}
+#endif
+
+TEST(resource_store_tests, read_mostly__get_shared_set_remove__no_error)
+{
+    std::filesystem::path rsc = textdir();
+
+    read_mostly_text_store text_store;
+    text_sptr koro_sptr = text_store.get_shared(rsc / "koro.txt");
+    ASSERT_EQ(koro_sptr, text_store.get_shared(rsc / ".." / rsc.filename() / "koro.txt"));
+    ASSERT_EQ(koro_sptr->contents, koro_contents());
+    text_sptr tale_sptr = std::make_shared<text>("Once upon a time");
+    text_store.set("default_tale", tale_sptr);
+    ASSERT_EQ(tale_sptr, text_store.get_shared("default_tale"));
+    ASSERT_EQ(text_store.size(), 2);
+    text_store.remove(rsc / "koro.txt");
+    ASSERT_EQ(text_store.size(), 1);
+    text_store.clear();
+    ASSERT_EQ(text_store.size(), 0);
+}
+
+TEST(resource_store_tests, read_mostly__concurrent_readers_and_writer__no_error)
+{
+    std::filesystem::path rsc = textdir();
+
+    read_mostly_text_store text_store;
+    text_sptr koro_sptr = text_store.get_shared(rsc / "koro.txt");
+    std::atomic_bool stop = false;
+    std::vector<std::jthread> readers;
+    for (int i = 0; i < 4; ++i)
+    {
+        readers.emplace_back([&]() {
+            while (!stop)
+                ASSERT_EQ(text_store.get_shared(rsc / "koro.txt"), koro_sptr);
+        });
+    }
+    for (int i = 0; i < 200; ++i)
+    {
+        text_store.set("default_tale", std::make_shared<text>("Once upon a time"));
+        text_store.remove("default_tale");
+    }
+    stop = true;
+    readers.clear();
+    ASSERT_EQ(text_store.size(), 1);
+}
+
+TEST(resource_store_tests, sharded__insert_get_shared_remove__no_error)
+{
+    std::filesystem::path rsc = textdir();
+
+    sharded_text_store text_store;
+    text_store.reserve(64);
+    for (int i = 0; i < 64; ++i)
+        ASSERT_TRUE(text_store.insert(std::format("tale_{}", i), std::make_shared<text>(std::format("Tale {}", i))));
+    ASSERT_EQ(text_store.size(), 64);
+    for (int i = 0; i < 64; ++i)
+        ASSERT_EQ(text_store.get_shared(std::format("tale_{}", i))->contents, std::format("Tale {}", i));
+    text_sptr koro_sptr = text_store.get_shared(rsc / "koro.txt");
+    ASSERT_EQ(koro_sptr, text_store.get_shared(rsc / ".." / rsc.filename() / "koro.txt"));
+    ASSERT_EQ(text_store.size(), 65);
+    text_store.remove(rsc / "koro.txt");
+    text_store.remove("tale_0");
+    ASSERT_EQ(text_store.size(), 63);
+    text_store.clear();
+    ASSERT_EQ(text_store.size(), 0);
+}
+
+TEST(resource_store_tests, get_shared_async__concurrent_calls_same_file__loaded_once)
+{
+    std::filesystem::path rsc = textdir();
+
+    rsce::resource_store<counted_text> text_store;
+    counted_text::number_of_loads = 0;
+    rsce::loader_thread_pool thread_pool(4);
+    std::vector<rsce::resource_future<counted_text>> rsc_futures;
+    for (int i = 0; i < 8; ++i)
+        rsc_futures.push_back(text_store.get_shared_async(rsc / "koro.txt", thread_pool));
+    text_sptr koro_sptr = text_store.get_shared(rsc / "koro.txt");
+    for (const rsce::resource_future<counted_text>& rsc_future : rsc_futures)
+        ASSERT_EQ(rsc_future.get(), koro_sptr);
+    ASSERT_EQ(counted_text::number_of_loads, 1);
+    ASSERT_EQ(text_store.size(), 1);
+}
+
+TEST(resource_store_tests, preload_async__duplicated_paths__loaded_once)
+{
+    std::filesystem::path rsc = textdir();
+
+    rsce::resource_store<counted_text> text_store;
+    counted_text::number_of_loads = 0;
+    rsce::loader_thread_pool thread_pool(2);
+    text_sptr koro_sptr = text_store.get_shared(rsc / "koro.txt");
+    const std::array rsc_paths{ rsc / "koro.txt", rsc / "tiki.txt", rsc / "../text/tiki.txt", rsc / "tiki.txt" };
+    rsce::resource_preloading preloading = text_store.preload_async(rsc_paths, thread_pool);
+    ASSERT_TRUE(preloading.valid());
+    preloading.wait();
+    ASSERT_FALSE(preloading.valid());
+    ASSERT_EQ(counted_text::number_of_loads, 2);
+    ASSERT_EQ(text_store.size(), 2);
+    ASSERT_EQ(text_store.get_shared(rsc / "koro.txt"), koro_sptr);
+    ASSERT_EQ(text_store.get_shared(rsc / "tiki.txt")->contents, tiki_contents());
+}
+
+TEST(resource_store_tests, preload_async__file_does_not_exist__exception_on_wait)
+{
+    std::filesystem::path rsc = textdir();
+
+    read_mostly_text_store text_store;
+    rsce::loader_thread_pool thread_pool(2);
+    const std::array rsc_paths{ rsc / "koro.txt", rsc / "not_found.txt", rsc / "tiki.txt" };
+    rsce::resource_preloading preloading = text_store.preload_async(rsc_paths, thread_pool);
+    ASSERT_THROW(preloading.wait(), std::filesystem::filesystem_error);
+    ASSERT_EQ(text_store.size(), 2);
+    ASSERT_EQ(text_store.get_shared(rsc / "tiki.txt")->contents, tiki_contents());
+}
+
+TEST(resource_store_tests, preload_async__negative_cache_failures__remembered)
+{
+    std::filesystem::path rsc = textdir();
+
+    rsce::default_resource_store<failing_text, rsce::negative_cached_resource_store_policy<>> text_store;
+    failing_text::number_of_loads = 0;
+    rsce::loader_thread_pool thread_pool(2);
+    const std::array rsc_paths{ rsc / "koro.txt", rsc / "not_found.txt" };
+    ASSERT_EQ(text_store.preload_async(rsc_paths, thread_pool).wait(std::nothrow).size(), 2);
+    ASSERT_EQ(failing_text::number_of_loads, 1);
+    ASSERT_EQ(text_store.get_shared(rsc / "../text/koro.txt", std::nothrow), nullptr);
+    ASSERT_EQ(text_store.get_shared(rsc / "not_found.txt", std::nothrow), nullptr);
+    ASSERT_EQ(text_store.preload_async(rsc_paths, thread_pool).wait(std::nothrow).size(), 2);
+    ASSERT_EQ(failing_text::number_of_loads, 1);
+}
+
+TEST(resource_store_tests, get_shared__non_canonical_path__same_resource)
+{
+    std::filesystem::path rsc = textdir();
+
+    rsce::resource_store<text> text_store;
+    text_sptr koro_sptr = text_store.get_shared(rsc / "../text/koro.txt");
+    ASSERT_EQ(text_store.get_shared(rsc / "../text/koro.txt"), koro_sptr);
+    ASSERT_EQ(text_store.get_shared(rsc / "koro.txt"), koro_sptr);
+    text_store.remove(rsc / "../text/koro.txt");
+    ASSERT_EQ(text_store.size(), 0);
+}
+
+TEST(resource_store_tests, invalidate_canonical_paths__link_changed__new_target)
+{
+    std::filesystem::path rsc = textdir();
+    std::filesystem::path link_path = std::filesystem::temp_directory_path() / "rsce_canonical_link.txt";
+    std::filesystem::remove(link_path);
+    std::filesystem::create_symlink(rsc / "koro.txt", link_path);
+
+    rsce::resource_store<text> text_store;
+    ASSERT_EQ(text_store.get_shared(link_path)->contents, koro_contents());
+    std::filesystem::remove(link_path);
+    std::filesystem::create_symlink(rsc / "tiki.txt", link_path);
+    ASSERT_EQ(text_store.get_shared(link_path)->contents, koro_contents());
+    text_store.invalidate_canonical_paths();
+    ASSERT_EQ(text_store.get_shared(link_path)->contents, tiki_contents());
+    std::filesystem::remove(link_path);
+}
+
+TEST(resource_store_tests, lexical__non_normal_path__same_resource)
+{
+    std::filesystem::path rsc = textdir();
+
+    lexical_text_store text_store;
+    text_sptr koro_sptr = text_store.get_shared(rsc / "../text/./koro.txt");
+    ASSERT_EQ(text_store.get_shared(rsc / "koro.txt"), koro_sptr);
+    ASSERT_EQ(koro_sptr->contents, koro_contents());
+    ASSERT_ANY_THROW(text_store.get_shared(rsc / "not_found.txt"));
+    text_store.remove(rsc / "./koro.txt");
+    ASSERT_EQ(text_store.size(), 0);
+}
+
+TEST(resource_store_tests, lexical__fixed_root_relative_path__same_resource)
+{
+    std::filesystem::path rsc = textdir();
+
+    rsce::default_resource_store<text, rooted_lexical_policy> text_store;
+    text_sptr tiki_sptr = text_store.get_shared("tiki.txt");
+    ASSERT_EQ(text_store.get_shared(rsc / "tiki.txt"), tiki_sptr);
+    ASSERT_EQ(tiki_sptr->contents, tiki_contents());
+}
+
+TEST(resource_store_tests, get_shared__string_view__same_resource)
+{
+    const std::string koro_path = (textdir() / "koro.txt").string();
+    const std::string other_koro_path = (textdir() / "../text/koro.txt").string();
+
+    rsce::resource_store<text> text_store;
+    ASSERT_EQ(text_store.find(koro_path), nullptr);
+    text_sptr koro_sptr = text_store.get_shared(std::string_view(koro_path));
+    ASSERT_EQ(text_store.find(koro_path), koro_sptr);
+    ASSERT_EQ(text_store.find(other_koro_path), nullptr);
+    ASSERT_EQ(text_store.get_shared(other_koro_path.c_str()), koro_sptr);
+    ASSERT_EQ(text_store.find(other_koro_path), koro_sptr);
+    ASSERT_EQ(text_store.get_shared(std::filesystem::path(koro_path)), koro_sptr);
+}
+
+TEST(resource_store_tests, intern__same_canonical_path__same_id)
+{
+    std::filesystem::path rsc = textdir();
+
+    rsce::resource_store<text> text_store;
+    rsce::resource_id<text> koro_id = text_store.intern(rsc / "koro.txt");
+    rsce::resource_id<text> tiki_id = text_store.intern(rsc / "tiki.txt");
+    ASSERT_TRUE(koro_id.valid());
+    ASSERT_NE(koro_id, tiki_id);
+    ASSERT_EQ(text_store.intern(rsc / "../text/koro.txt"), koro_id);
+    ASSERT_EQ(text_store.size(), 0);
+    ASSERT_THROW(text_store.intern(rsc / "not_found.txt"), std::filesystem::filesystem_error);
+}
+
+TEST(resource_store_tests, get_shared__resource_id__same_resource)
+{
+    std::filesystem::path rsc = textdir();
+
+    rsce::resource_store<text> text_store;
+    text_sptr tiki_sptr = text_store.get_shared(rsc / "tiki.txt");
+    rsce::resource_id<text> koro_id = text_store.intern(rsc / "koro.txt");
+    rsce::resource_id<text> tiki_id = text_store.intern(rsc / "tiki.txt");
+    ASSERT_EQ(text_store.get_shared(tiki_id), tiki_sptr);
+    text_sptr koro_sptr = text_store.get_shared(koro_id);
+    ASSERT_EQ(koro_sptr->contents, koro_contents());
+    ASSERT_EQ(text_store.get_shared(rsc / "koro.txt"), koro_sptr);
+
+    text_sptr new_koro_sptr = std::make_shared<text>();
+    text_store.set(std::filesystem::canonical(rsc / "koro.txt"), new_koro_sptr);
+    ASSERT_EQ(text_store.get_shared(koro_id), new_koro_sptr);
+    text_store.remove(rsc / "koro.txt");
+    ASSERT_NE(text_store.get_shared(koro_id), new_koro_sptr);
+    text_store.clear();
+    ASSERT_EQ(text_store.get_shared(tiki_id)->contents, tiki_contents());
+    ASSERT_THROW(text_store.get_shared(rsce::resource_id<text>()), std::out_of_range);
+}
+
+TEST(resource_store_tests, get_handle__resource_file_exists__valid_handle)
+{
+    std::filesystem::path rsc = textdir();
+
+    rsce::resource_store<text> text_store;
+    rsce::resource_handle<text> koro_handle = text_store.get_handle(rsc / "koro.txt");
+    ASSERT_TRUE(koro_handle);
+    ASSERT_EQ(koro_handle->contents, koro_contents());
+    ASSERT_EQ(koro_handle.get(), text_store.get_shared(rsc / "koro.txt").get());
+    ASSERT_EQ(koro_handle.pin(), text_store.get_shared(koro_handle.id()));
+    ASSERT_EQ(text_store.get_handle(koro_handle.id()).get(), koro_handle.get());
+    ASSERT_FALSE(rsce::resource_handle<text>().valid());
+}
+
+TEST(resource_store_tests, get_handle__resource_replaced_or_removed__invalid_handle)
+{
+    std::filesystem::path rsc = textdir();
+
+    rsce::resource_store<text> text_store;
+    rsce::resource_handle<text> koro_handle = text_store.get_handle(rsc / "koro.txt");
+    text_sptr pinned_koro_sptr = koro_handle.pin();
+    text_store.set(std::filesystem::canonical(rsc / "koro.txt"), std::make_shared<text>());
+    ASSERT_FALSE(koro_handle.valid());
+    ASSERT_EQ(koro_handle.pin(), nullptr);
+    ASSERT_EQ(pinned_koro_sptr->contents, koro_contents());
+
+    rsce::resource_handle<text> new_koro_handle = text_store.get_handle(rsc / "koro.txt");
+    ASSERT_TRUE(new_koro_handle.valid());
+    ASSERT_EQ(new_koro_handle.id(), koro_handle.id());
+    text_store.remove(rsc / "koro.txt");
+    ASSERT_FALSE(new_koro_handle.valid());
+    ASSERT_EQ(text_store.get_handle(koro_handle.id())->contents, koro_contents());
+}
+
+TEST(resource_store_tests, get_shared__flat_dictionary__same_resource)
+{
+    std::filesystem::path rsc = textdir();
+    const std::string koro_path = (rsc / "koro.txt").string();
+
+    flat_text_store text_store;
+    text_sptr koro_sptr = text_store.get_shared(rsc / "koro.txt");
+    ASSERT_EQ(koro_sptr->contents, koro_contents());
+    ASSERT_EQ(text_store.get_shared(rsc / "../text/koro.txt"), koro_sptr);
+    ASSERT_EQ(text_store.find(koro_path), koro_sptr);
+    text_sptr tiki_sptr = text_store.get_shared(rsc / "tiki.txt");
+    ASSERT_EQ(text_store.size(), 2);
+    text_store.remove(rsc / "koro.txt");
+    ASSERT_EQ(text_store.find(koro_path), nullptr);
+    ASSERT_EQ(text_store.get_shared(rsc / "tiki.txt"), tiki_sptr);
+    text_store.clear();
+    ASSERT_EQ(text_store.size(), 0);
+}
+
+TEST(resource_store_tests, hash_path_string__literal__same_hash)
+{
+    using namespace rsce::literals;
+
+    constexpr rsce::hashed_path_view koro_path = "/rsc/koro.txt"_rsc;
+    static_assert(koro_path.hash() == rsce::hash_path_string("/rsc/koro.txt"));
+    static_assert(koro_path.native() == "/rsc/koro.txt");
+    ASSERT_EQ(rsce::hashed_path(std::filesystem::path("/rsc/koro.txt")).hash(), koro_path.hash());
+    ASSERT_EQ(rsce::hashed_path(koro_path).path(), std::filesystem::path("/rsc/koro.txt"));
+    ASSERT_NE(("/rsc/tiki.txt"_rsc).hash(), koro_path.hash());
+}
+
+TEST(resource_store_tests, get_shared__hashed_path__same_resource)
+{
+    std::filesystem::path rsc = textdir();
+    const rsce::hashed_path koro_path(rsc / "koro.txt");
+    const rsce::hashed_path other_koro_path(rsc / "../text/koro.txt");
+
+    rsce::resource_store<text> text_store;
+    ASSERT_EQ(text_store.find(koro_path), nullptr);
+    text_sptr koro_sptr = text_store.get_shared(koro_path);
+    ASSERT_EQ(koro_sptr->contents, koro_contents());
+    ASSERT_EQ(text_store.find(koro_path), koro_sptr);
+    ASSERT_EQ(text_store.find(other_koro_path), nullptr);
+    ASSERT_EQ(text_store.get_shared(other_koro_path), koro_sptr);
+    ASSERT_EQ(text_store.find(other_koro_path), koro_sptr);
+    ASSERT_EQ(text_store.get_shared(rsc / "koro.txt"), koro_sptr);
+
+    sharded_text_store sharded_store;
+    text_sptr sharded_koro_sptr = sharded_store.get_shared(other_koro_path);
+    ASSERT_EQ(sharded_store.find(koro_path), sharded_koro_sptr);
+    ASSERT_EQ(sharded_store.get_shared(koro_path.path()), sharded_koro_sptr);
+}
+
+TEST(resource_store_tests, get_shared__thread_cache__invalidated_by_modifications)
+{
+    std::filesystem::path rsc = textdir();
+
+    thread_cached_text_store text_store;
+    text_sptr koro_sptr = text_store.get_shared(rsc / "koro.txt");
+    ASSERT_EQ(text_store.get_shared(rsc / "koro.txt"), koro_sptr);
+    ASSERT_EQ(text_store.get_shared((rsc / "koro.txt").string()), koro_sptr);
+    ASSERT_EQ(text_store.get_shared(rsce::hashed_path(rsc / "koro.txt")), koro_sptr);
+
+    text_sptr new_koro_sptr = std::make_shared<text>();
+    text_store.set(std::filesystem::canonical(rsc / "koro.txt"), new_koro_sptr);
+    ASSERT_EQ(text_store.get_shared(rsc / "koro.txt"), new_koro_sptr);
+    ASSERT_EQ(text_store.get_shared((rsc / "koro.txt").string()), new_koro_sptr);
+
+    text_store.remove(rsc / "koro.txt");
+    text_sptr reloaded_koro_sptr = text_store.get_shared(rsc / "koro.txt");
+    ASSERT_NE(reloaded_koro_sptr, new_koro_sptr);
+    ASSERT_EQ(reloaded_koro_sptr->contents, koro_contents());
+
+    text_store.clear();
+    ASSERT_NE(text_store.get_shared(rsc / "koro.txt"), reloaded_koro_sptr);
+    ASSERT_EQ(text_store.size(), 1);
+}
+
+TEST(resource_store_tests, get_shared__thread_cache_of_other_store__distinct_resources)
+{
+    const std::filesystem::path koro_path = std::filesystem::canonical(textdir() / "koro.txt");
+
+    thread_cached_text_store text_store;
+    thread_cached_text_store other_text_store;
+    text_sptr koro_sptr = std::make_shared<text>();
+    text_sptr other_koro_sptr = std::make_shared<text>();
+    text_store.insert(koro_path, koro_sptr);
+    other_text_store.insert(koro_path, other_koro_sptr);
+    for (int i = 0; i < 2; ++i)
+    {
+        ASSERT_EQ(text_store.get_shared(koro_path), koro_sptr);
+        ASSERT_EQ(other_text_store.get_shared(koro_path), other_koro_sptr);
+    }
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <arba/rsce/basic_resource_manager.hpp>
+
+#include <cstddef>
+#include <filesystem>
+#include <istream>
+#include <span>
+#include <string>
+
+class memory_rsc
+{
+public:
+    std::string contents;
+
+    inline bool operator<=>(const memory_rsc&) const = default;
+
+    bool load_from_memory(std::span<const std::byte> bytes)
+    {
+        contents.assign(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+        return !contents.empty()
+               && ((contents[0] >= 'a' && contents[0] <= 'z') || (contents[0] >= 'A' && contents[0] <= 'Z'));
+    }
+
+    // Never called: load_from_memory() is preferred.
+    bool load_from_binary_stream(std::istream&) { return false; }
+    bool load_from_file(const std::filesystem::path&) { return false; }
+};
+
+class memory_rsc_mngr
+{
+public:
+    std::string contents;
+
+    inline bool operator<=>(const memory_rsc_mngr&) const = default;
+
+    void load_from_memory(std::span<const std::byte> bytes, rsce::basic_resource_manager&)
+    {
+        contents.assign(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+    }
+
+    bool load_from_binary_stream(std::istream&, rsce::basic_resource_manager&) { return false; }
+};
@@ -0,0 +1,126 @@
+#include <arba/rsce/resource_pack.hpp>
+
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Tests of the rsce-pack tool, run on the directory test/resources.
+
+namespace
+{
+const std::filesystem::path& input_dpath()
+{
+    static const std::filesystem::path dpath = std::filesystem::path(RSCE_PACK_INPUT_PATH);
+    return dpath;
+}
+
+std::filesystem::path output_fpath(std::string_view name)
+{
+    return std::filesystem::temp_directory_path() / name;
+}
+
+// Runs rsce-pack with arguments, its output discarded, and returns its exit status (0 on success).
+int run_rsce_pack(std::string_view arguments)
+{
+#ifdef _WIN32
+    constexpr std::string_view null_device = "NUL";
+#else
+    constexpr std::string_view null_device = "/dev/null";
+#endif
+    std::string command = "\"" + std::string(RSCE_PACK_PATH) + "\" ";
+    command += arguments;
+    command += " >" + std::string(null_device) + " 2>&1";
+#ifdef _WIN32
+    // cmd.exe strips the outer quotes of a command starting with a quote.
+    command = "\"" + command + "\"";
+#endif
+    return std::system(command.c_str());
+}
+
+std::string quoted(const std::filesystem::path& path)
+{
+    return "\"" + path.string() + "\"";
+}
+
+std::vector<char> read_file(const std::filesystem::path& fpath)
+{
+    std::ifstream stream(fpath, std::ios::binary);
+    return std::vector<char>(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+}
+} // namespace
+
+// Unit tests:
+
+TEST(rsce_pack_tests, main__input_directory__pack_of_its_files)
+{
+    const std::filesystem::path pack_path = output_fpath("rsce_pack_tests_main.pack");
+    ASSERT_EQ(run_rsce_pack("--prefix resources " + quoted(input_dpath()) + " " + quoted(pack_path)), 0);
+    {
+        rsce::resource_pack pack(pack_path);
+        std::size_t number_of_files = 0;
+        for (const std::filesystem::directory_entry& entry :
+             std::filesystem::recursive_directory_iterator(input_dpath()))
+        {
+            if (!entry.is_regular_file())
+                continue;
+            ++number_of_files;
+            const std::string entry_path =
+                "resources/" + entry.path().lexically_relative(input_dpath()).generic_string();
+            const std::vector<char> contents = read_file(entry.path());
+            const std::span<const std::byte> bytes = pack.at(entry_path);
+            ASSERT_EQ(std::string_view(reinterpret_cast<const char*>(bytes.data()), bytes.size()),
+                      std::string_view(contents.data(), contents.size()));
+        }
+        ASSERT_EQ(pack.size(), number_of_files);
+    }
+    ASSERT_FALSE(std::filesystem::exists(output_fpath("rsce_pack_tests_main.pack.tmp")));
+    std::filesystem::remove(pack_path);
+}
+
+TEST(rsce_pack_tests, main__help__success)
+{
+    ASSERT_EQ(run_rsce_pack("--help"), 0);
+    ASSERT_EQ(run_rsce_pack("-h"), 0);
+}
+
+TEST(rsce_pack_tests, main__bad_options__failure_and_no_pack)
+{
+    const std::filesystem::path pack_path = output_fpath("rsce_pack_tests_bad.pack");
+    std::filesystem::remove(pack_path);
+    const std::string paths = quoted(input_dpath()) + " " + quoted(pack_path);
+    ASSERT_NE(run_rsce_pack(""), 0);
+    ASSERT_NE(run_rsce_pack(quoted(input_dpath())), 0);
+    ASSERT_NE(run_rsce_pack(paths + " extra"), 0);
+    ASSERT_NE(run_rsce_pack("--unknown " + paths), 0);
+    ASSERT_NE(run_rsce_pack("--threads 0 " + paths), 0);
+    ASSERT_NE(run_rsce_pack("--threads many " + paths), 0);
+    ASSERT_NE(run_rsce_pack("--alignment 3 " + paths), 0);
+    ASSERT_NE(run_rsce_pack(paths + " --prefix"), 0);
+    ASSERT_NE(run_rsce_pack(quoted(input_dpath() / "not_found") + " " + quoted(pack_path)), 0);
+    ASSERT_FALSE(std::filesystem::exists(pack_path));
+}
+
+TEST(rsce_pack_tests, main__1_or_8_threads__identical_packs)
+{
+    const std::filesystem::path pack_1_path = output_fpath("rsce_pack_tests_1.pack");
+    const std::filesystem::path pack_8_path = output_fpath("rsce_pack_tests_8.pack");
+    const std::string input = quoted(input_dpath());
+    for (std::string_view options : { "", "--deduplicate --alignment 64 " })
+    {
+        ASSERT_EQ(run_rsce_pack(std::string(options) + "--threads 1 " + input + " " + quoted(pack_1_path)), 0);
+        ASSERT_EQ(run_rsce_pack(std::string(options) + "--threads 8 " + input + " " + quoted(pack_8_path)), 0);
+        const std::vector<char> pack_1 = read_file(pack_1_path);
+        ASSERT_FALSE(pack_1.empty());
+        ASSERT_EQ(pack_1, read_file(pack_8_path));
+    }
+    std::filesystem::remove(pack_1_path);
+    std::filesystem::remove(pack_8_path);
+}
@@ -0,0 +1,86 @@
+#include "resources/resources_helper.hpp"
+#include "resources/story.hpp"
+#include "resources/text.hpp"
+#include <arba/rsce/static_resource_manager.hpp>
+
+#include <gtest/gtest.h>
+
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Composite resource loading its sub-resources with any resource manager.
+class text_pair
+{
+public:
+    std::shared_ptr<text> first;
+    std::shared_ptr<text> second;
+
+    template <class resource_manager_type>
+    bool load_from_file(const std::filesystem::path& fpath, resource_manager_type& rmanager)
+    {
+        rsce::resource_future<text> second_future =
+            rmanager.template get_shared_async<text>(fpath.parent_path() / "tiki.txt");
+        first = rmanager.template get_shared<text>(fpath);
+        second = second_future.get();
+        return first && second;
+    }
+};
+
+using static_manager = rsce::static_resource_manager<text, story, text_pair>;
+
+static_assert(static_manager::manages<text>);
+static_assert(!static_manager::manages<int>);
+static_assert(rsce::traits::is_loadable_resource_v<text_pair, static_manager>);
+
+// Unit tests:
+
+TEST(static_resource_manager_tests, get_shared__resource_file_exists__no_exception)
+{
+    std::filesystem::path rsc = textdir();
+
+    static_manager rmanager;
+    std::shared_ptr<text> koro_sptr = rmanager.get_shared<text>(rsc / "koro.txt");
+    ASSERT_EQ(koro_sptr->contents, koro_contents());
+    ASSERT_EQ(rmanager.get_shared<text>((rsc / "koro.txt").string()), koro_sptr);
+    ASSERT_EQ(&rmanager.get<text>(rsc / "koro.txt"), koro_sptr.get());
+    ASSERT_EQ(rmanager.number_of_resources<text>(), 1);
+    ASSERT_EQ(rmanager.number_of_resources<story>(), 0);
+    ASSERT_EQ(rmanager.get_shared<text>(rsc / "not_found.txt", std::nothrow), nullptr);
+}
+
+TEST(static_resource_manager_tests, get_shared__composite_resource__sub_resources_stored)
+{
+    std::filesystem::path rsc = textdir();
+
+    static_manager rmanager(2);
+    std::shared_ptr<text_pair> pair_sptr = rmanager.get_shared<text_pair>(rsc / "koro.txt");
+    ASSERT_EQ(pair_sptr->first->contents, koro_contents());
+    ASSERT_EQ(pair_sptr->second->contents, tiki_contents());
+    ASSERT_EQ(rmanager.number_of_resources<text>(), 2);
+    ASSERT_EQ(rmanager.get_shared<text>(rsc / "tiki.txt"), pair_sptr->second);
+}
+
+TEST(static_resource_manager_tests, preload__resource_files_exist__resources_stored)
+{
+    std::filesystem::path rsc = textdir();
+    const std::vector<std::filesystem::path> rsc_paths{ rsc / "koro.txt", rsc / "tiki.txt" };
+
+    static_manager rmanager(std::make_shared<rsce::loader_thread_pool>(2));
+    rmanager.preload<text>(rsc_paths);
+    ASSERT_EQ(rmanager.number_of_resources<text>(), 2);
+    rsce::resource_future<text> koro_future = rmanager.load_async<text>(rsc / "koro.txt");
+    ASSERT_EQ(koro_future.get()->contents, koro_contents());
+}
+
+TEST(static_resource_manager_tests, insert_remove__rsc_sptr__no_error)
+{
+    static_manager rmanager;
+    std::shared_ptr<story> tale_sptr = std::make_shared<story>();
+    ASSERT_TRUE(rmanager.insert("default_tale", tale_sptr));
+    ASSERT_FALSE(rmanager.insert("default_tale", std::make_shared<story>()));
+    ASSERT_EQ(rmanager.get_shared<story>("default_tale"), tale_sptr);
+    rmanager.remove<story>("default_tale");
+    ASSERT_EQ(rmanager.number_of_resources<story>(), 0);
+}
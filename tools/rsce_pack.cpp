@@ -0,0 +1,117 @@
+#include <arba/rsce/resource_pack.hpp>
+
+#include <charconv>
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <exception>
+#include <filesystem>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <system_error>
+
+// Writes the regular files of a directory tree in a resource pack (see rsce::resource_pack). The pack only depends on
+// the files and on the options, so that building it twice gives the same file.
+
+namespace
+{
+constexpr std::string_view usage = R"(Usage: rsce-pack [options] <input-directory> <output-pack>
+
+Options:
+  --prefix <prefix>   Prefix of the entry paths, e.g. 'ui' for 'ui/font.ttf' (none by default).
+  --alignment <n>     Alignment of the blobs, a power of two (16 by default).
+  --deduplicate       Store the identical files once.
+  --threads <n>       Number of threads reading and hashing the files (hardware concurrency by default).
+  -h, --help          Print this help.
+)";
+
+std::optional<std::size_t> parse_size(std::string_view argument)
+{
+    std::size_t value = 0;
+    auto [end, error_code] = std::from_chars(argument.data(), argument.data() + argument.size(), value);
+    if (error_code != std::errc() || end != argument.data() + argument.size())
+        return std::nullopt;
+    return value;
+}
+
+int fail(std::string_view message)
+{
+    std::cerr << "rsce-pack: " << message << std::endl << std::endl << usage;
+    return EXIT_FAILURE;
+}
+} // namespace
+
+int main(int argc, char** argv)
+{
+    std::string prefix;
+    std::size_t alignment = 16;
+    bool deduplicate = false;
+    std::optional<std::size_t> number_of_threads;
+    std::filesystem::path input_dpath;
+    std::filesystem::path output_fpath;
+    std::size_t number_of_paths = 0;
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string_view argument = argv[i];
+        auto option_value = [&]() -> std::optional<std::string_view> {
+            if (i + 1 == argc)
+                return std::nullopt;
+            return std::string_view(argv[++i]);
+        };
+        if (argument == "-h" || argument == "--help")
+        {
+            std::cout << usage;
+            return EXIT_SUCCESS;
+        }
+        else if (argument == "--deduplicate")
+            deduplicate = true;
+        else if (argument == "--prefix")
+        {
+            std::optional value = option_value();
+            if (!value)
+                return fail("missing value of --prefix.");
+            prefix = *value;
+        }
+        else if (argument == "--alignment" || argument == "--threads")
+        {
+            std::optional value = option_value();
+            std::optional<std::size_t> size = value ? parse_size(*value) : std::nullopt;
+            if (!size || *size == 0)
+                return fail(std::string("invalid value of ") + std::string(argument) + ".");
+            (argument == "--alignment" ? alignment : number_of_threads.emplace()) = *size;
+        }
+        else if (argument.starts_with("-"))
+            return fail(std::string("unknown option ") + std::string(argument) + ".");
+        else if (number_of_paths++ == 0)
+            input_dpath = argument;
+        else if (number_of_paths == 2)
+            output_fpath = argument;
+        else
+            return fail("too many arguments.");
+    }
+    if (number_of_paths != 2)
+        return fail("expected an input directory and an output pack.");
+
+    try
+    {
+        const auto start_time = std::chrono::steady_clock::now();
+        rsce::resource_pack_builder builder(alignment);
+        builder.set_deduplication(deduplicate);
+        if (number_of_threads)
+            builder.set_number_of_threads(*number_of_threads);
+        builder.add_directory(input_dpath, prefix, output_fpath);
+        const rsce::resource_pack_builder::write_summary summary = builder.write(output_fpath);
+        const std::chrono::duration<double> duration = std::chrono::steady_clock::now() - start_time;
+        std::cout << output_fpath.string() << ": " << summary.number_of_entries << " entries, "
+                  << summary.number_of_blobs << " blobs, " << summary.file_size << " bytes, in " << duration.count()
+                  << " s" << std::endl;
+    }
+    catch (const std::exception& exception)
+    {
+        std::cerr << "rsce-pack: " << exception.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}